@@ -30,11 +30,16 @@ LibjError libj_object_add(Libj *libj, LibjJson *json, const char *name, LibjJson
 
 LibjError libj_object_add_ex(Libj *libj, LibjJson *json, const char *name, size_t name_size, LibjJson *value);
 
+/* Move *value into json as its last member. See libj_object_insert_at_take_ex(). */
+LibjError libj_object_add_take(Libj *libj, LibjJson *json, const char *name, LibjJson **value);
+
+LibjError libj_object_add_take_ex(Libj *libj, LibjJson *json, const char *name, size_t name_size, LibjJson **value);
+
 LibjError libj_object_count_versions(Libj *libj, LibjJson *json, const char *name, size_t *nversions);
 
 LibjError libj_object_get_version(Libj *libj, LibjJson *json, LibjJson **value, const char *name, size_t version);
 
-#define libj_object_get_string(...) libj_object_get_string_(__VA_ARGS__, NULL);
+#define libj_object_get_string(...) libj_object_get_string_(__VA_ARGS__, NULL)
 
 LibjError libj_object_get_string_(Libj *libj, LibjJson *json, char **value, const char *name, ...);
 
@@ -138,6 +143,37 @@ LibjError libj_object_remove_ex(Libj *libj, LibjJson *json, const char *name, si
 
 LibjError libj_object_remove_all_ex(Libj *libj, LibjJson *json, const char *name, size_t name_size);
 
+/**********************************************************************************
+ * Compiled path functions
+ **********************************************************************************/
+
+/* Chain of member names prepared once to look up the same member in many objects. Names are interned in the
+ * symbol table of libj (see libj_intern()) so lookups neither measure nor hash them. Path is valid until
+ * libj_finish(). */
+typedef struct LibjPath_ LibjPath;
+
+#define libj_path_compile(...) libj_path_compile_(__VA_ARGS__, NULL)
+
+LibjError libj_path_compile_(Libj *libj, LibjPath **path, const char *name, ...);
+
+LibjError libj_path_compile_v(Libj *libj, LibjPath **path, const char *name, va_list args);
+
+/* Release path. *path == NULL is allowed. */
+LibjError libj_path_free(Libj *libj, LibjPath **path);
+
+/* Same as libj_object_get() with the names of path. */
+LibjError libj_path_get(Libj *libj, LibjJson *json, LibjPath *path, LibjJson **value);
+
+LibjError libj_path_get_string(Libj *libj, LibjJson *json, LibjPath *path, char **value);
+
+LibjError libj_path_get_integer(Libj *libj, LibjJson *json, LibjPath *path, int64_t *value);
+
+LibjError libj_path_get_real(Libj *libj, LibjJson *json, LibjPath *path, double *value);
+
+LibjError libj_path_get_number(Libj *libj, LibjJson *json, LibjPath *path, char **value);
+
+LibjError libj_path_get_bool(Libj *libj, LibjJson *json, LibjPath *path, bool *value);
+
 /**********************************************************************************
  * Array's functions convenience
  **********************************************************************************/
@@ -28,6 +28,7 @@ typedef enum {
     LIBJ_ERROR_SYNTAX,
     LIBJ_ERROR_IO,
     LIBJ_ERROR_ZERO,
+    LIBJ_ERROR_STOPPED,
 } LibjError;
 
 /* Options for libj_to_string. The string "$" will be replaced
@@ -62,6 +63,13 @@ typedef struct LibjJson_ LibjJson;
 /* A type of library context that must be passed into libj_* functions. */
 typedef struct Libj_ Libj;
 
+/* A region that json values may be allocated from. Values allocated from a document are not released one by
+ * one but all at once when the document is freed. */
+typedef struct LibjDocument_ LibjDocument;
+
+/* A member name interned in the symbol table of libj. Equal names share one symbol. */
+typedef struct LibjSymbol_ LibjSymbol;
+
 /* Create and initialize libj object that must be passed into most of the functions
  * of this library. */
 LibjError libj_start(Libj **libj);
@@ -89,12 +97,45 @@ LibjError libj_string_to_error(const char *string);
 /* Get type of json. json == NULL is not allowed. */
 LibjError libj_type_of(Libj *libj, LibjJson *json, LibjType *type);
 
+/**********************************************************************************
+ * Document's functions
+ **********************************************************************************/
+
+/* Create an empty document. */
+LibjError libj_document_create(Libj *libj, LibjDocument **document);
+
+/* Release document together with all the json values allocated from it. *document == NULL is allowed. */
+LibjError libj_document_free(Libj *libj, LibjDocument **document);
+
+/* Make functions that create json values (libj_*_create(), libj_copy(), libj_from_*()) allocate them from
+ * document. document == NULL makes them use the heap again. Adding a value to an array or an object allocated
+ * elsewhere stores a copy of the value. libj_free_json() on a value from a document only forgets the pointer. */
+LibjError libj_use_document(Libj *libj, LibjDocument *document);
+
+/**********************************************************************************
+ * Interning functions
+ **********************************************************************************/
+
+/* Make the parser and functions that add members to objects share one buffer between all equal member names
+ * instead of copying each of them. Such names belong to libj and json values holding them must not be used after
+ * libj_finish(). Symbols are only released by libj_finish(), so once the symbol table holds 65536 names new ones
+ * are copied as without interning. This keeps input with ever new member names from growing libj without bound. */
+LibjError libj_use_interning(Libj *libj, bool enable);
+
+/* Find or add name to the symbol table of libj. *symbol is valid until libj_finish(). Looking members up with a
+ * symbol skips hashing the name and compares names interned by libj by pointer. Names are added whatever the size
+ * of the table and take memory until libj_finish(). */
+LibjError libj_intern(Libj *libj, const char *name, size_t name_size, const LibjSymbol **symbol);
+
 /* Release resources associated with json. *json == NULL is allowed. */
 LibjError libj_free_json(Libj *libj, LibjJson **json);
 
 /* Create a copy of source and place it into target. */
 LibjError libj_copy(Libj *libj, LibjJson *source, LibjJson **target);
 
+/* Release storage that array or object reserved for elements or members it doesn't have. */
+LibjError libj_shrink_to_fit(Libj *libj, LibjJson *json);
+
 /**********************************************************************************
  * Object's functions
  **********************************************************************************/
@@ -110,12 +151,23 @@ LibjError libj_object_count_versions_ex(
 LibjError libj_object_get_version_ex(
         Libj *libj, LibjJson *json, LibjJson **value, const char *name, size_t name_size, size_t version);
 
+/* Get the latest version of member named symbol. */
+LibjError libj_object_get_symbol(Libj *libj, LibjJson *json, const LibjSymbol *symbol, LibjJson **value);
+
 /* Insert new member before specified position. */
 LibjError libj_object_insert_at_ex(
         Libj *libj, LibjJson *json, size_t position, const char *name, size_t name_size, LibjJson *value);
 
+/* Same as libj_object_insert_at_ex() but *value is moved into json instead of being copied. On success *value
+ * is set to NULL and must not be freed by the caller. On failure *value is left untouched. */
+LibjError libj_object_insert_at_take_ex(
+        Libj *libj, LibjJson *json, size_t position, const char *name, size_t name_size, LibjJson **value);
+
 LibjError libj_object_get_size(Libj *libj, LibjJson *json, size_t *size);
 
+/* Make sure that object is able to hold capacity members without reallocating its storage. */
+LibjError libj_object_reserve(Libj *libj, LibjJson *json, size_t capacity);
+
 LibjError libj_object_get_member_at_ex(
         Libj *libj, LibjJson *json, size_t i, const char **name, size_t *name_size, LibjJson **value);
 
@@ -130,8 +182,15 @@ LibjError libj_array_create(Libj *libj, LibjJson **json);
 /* TODO: This should be convenience. Make libj_array_insert_at essential(). */
 LibjError libj_array_add(Libj *libj, LibjJson *json, LibjJson *element);
 
+/* Same as libj_array_add() but *element is moved into json instead of being copied. On success *element is
+ * set to NULL and must not be freed by the caller. On failure *element is left untouched. */
+LibjError libj_array_add_take(Libj *libj, LibjJson *json, LibjJson **element);
+
 LibjError libj_array_get_size(Libj *libj, LibjJson *json, size_t *size);
 
+/* Make sure that array is able to hold capacity elements without reallocating its storage. */
+LibjError libj_array_reserve(Libj *libj, LibjJson *json, size_t capacity);
+
 LibjError libj_array_get_element_at(Libj *libj, LibjJson *json, size_t i, LibjJson **element);
 
 LibjError libj_array_remove_at(Libj *libj, LibjJson *json, size_t index);
@@ -144,6 +203,7 @@ LibjError libj_get_integer(Libj *libj, LibjJson *json, int64_t *value);
 
 LibjError libj_get_real(Libj *libj, LibjJson *json, double *value);
 
+/* Get text of number. Text made for a number parsed in typed mode lives in libj until the next call. */
 LibjError libj_get_number(Libj *libj, LibjJson *json, char **value);
 
 LibjError libj_get_bool(Libj *libj, LibjJson *json, bool *value);
@@ -158,6 +218,8 @@ LibjError libj_string_create_ex(Libj *libj, LibjJson **json, const char *value,
 
 LibjError libj_integer_create(Libj *libj, LibjJson **json, int64_t value);
 
+/* Create number from finite value. It's stored as the shortest text that converts back into the same double.
+ * Returns LIBJ_ERROR_BAD_ARGUMENT for NaN and infinities. */
 LibjError libj_real_create(Libj *libj, LibjJson **json, double value);
 
 LibjError libj_number_create(Libj *libj, LibjJson **json, const char *value);
@@ -174,6 +236,17 @@ LibjError libj_null_create(Libj *libj, LibjJson **json);
 LibjError libj_to_string_ex(Libj *libj, LibjJson *json, char **json_string, size_t *json_string_size,
                             LibjToStringOptions *options);
 
+/* Receives serialized json piece by piece. Return false to stop serialization. */
+typedef bool (*LibjWriteCallback)(void *user, const char *bytes, size_t size);
+
+/* Convert json into a string which is passed to write in chunks as serialization goes instead of being collected
+ * in memory. Returns LIBJ_ERROR_IO if write fails in which case part of json may have been written already. */
+LibjError libj_to_writer(Libj *libj, LibjJson *json, LibjWriteCallback write, void *user,
+                         LibjToStringOptions *options);
+
+/* Write json into file descriptor fd in chunks. */
+LibjError libj_to_fd(Libj *libj, LibjJson *json, int fd, LibjToStringOptions *options);
+
 LibjError libj_from_string_ex(Libj *libj, LibjJson **json,
                               const char *input_string, size_t input_size,
                               const char **error_string);
@@ -181,5 +254,164 @@ LibjError libj_from_string_ex(Libj *libj, LibjJson **json,
 /* Parse json from byte sequence possibly containing '\0'. */
 LibjError libj_from_input_stream(Libj *libj, LibjJson **json, LibisInputStream *input, const char **error_string);
 
+/* Parse json from buffer and unescape strings in place so that they point into buffer instead of being copied.
+ * Numbers refer to their bytes in buffer. Contents of buffer are overwritten and buffer must outlive json. */
+LibjError libj_from_buffer_insitu(Libj *libj, LibjJson **json, char *buffer, size_t buffer_size,
+                                  const char **error_string);
+
+/* Parse json from buffer and make strings without escape sequences and numbers refer to their bytes in buffer
+ * instead of being copied. buffer is not modified and must outlive json. Such strings are copied the first time
+ * they are asked for, so libj_get_string_ex(), libj_get_number() and libj_object_get_member_at_ex() modify json
+ * and must not be called on it from several threads at once. */
+LibjError libj_from_buffer_view(Libj *libj, LibjJson **json, const char *buffer, size_t buffer_size,
+                                const char **error_string);
+
+/* Callbacks that receive json piece by piece as it's parsed instead of a tree. Callbacks that are NULL skip their
+ * events. Return false to stop parsing. Members come as on_key followed by events of the value. Bytes passed to
+ * callbacks are valid only until the callback returns and aren't null-terminated in general. */
+typedef struct {
+    bool (*on_null)(void *user);
+    bool (*on_bool)(void *user, bool value);
+    /* text is the number as it's written in input. */
+    bool (*on_number)(void *user, const char *text, size_t text_size);
+    /* value is unescaped and may contain '\0'. */
+    bool (*on_string)(void *user, const char *value, size_t value_size);
+    bool (*on_object_start)(void *user);
+    bool (*on_key)(void *user, const char *name, size_t name_size);
+    bool (*on_object_end)(void *user);
+    bool (*on_array_start)(void *user);
+    bool (*on_array_end)(void *user);
+} LibjHandler;
+
+/* Parse json from byte sequence possibly containing '\0' and pass it to handler without building json values.
+ * Numbers and strings without escape sequences are passed right from input_string and nothing is allocated for
+ * them. Returns LIBJ_ERROR_STOPPED if a callback returns false. */
+LibjError libj_parse_events(Libj *libj, const char *input_string, size_t input_size, const LibjHandler *handler,
+                            void *user, const char **error_string);
+
+/* Same as libj_parse_events() but input is read from stream. */
+LibjError libj_parse_events_from_input_stream(Libj *libj, LibisInputStream *input, const LibjHandler *handler,
+                                              void *user, const char **error_string);
+
+/* Kind of token that LibjReader returns. */
+typedef enum {
+    LIBJ_TOKEN_END, /* the whole value has been read */
+    LIBJ_TOKEN_NULL,
+    LIBJ_TOKEN_TRUE,
+    LIBJ_TOKEN_FALSE,
+    LIBJ_TOKEN_NUMBER,
+    LIBJ_TOKEN_STRING,
+    LIBJ_TOKEN_KEY,
+    LIBJ_TOKEN_OBJECT_START,
+    LIBJ_TOKEN_OBJECT_END,
+    LIBJ_TOKEN_ARRAY_START,
+    LIBJ_TOKEN_ARRAY_END,
+} LibjTokenType;
+
+/* A piece of json. value holds the number as it's written in input or the unescaped string or member name. It's
+ * not null-terminated in general and is valid until the reader is used next time. */
+typedef struct {
+    LibjTokenType type;
+    const char *value;
+    size_t value_size;
+} LibjToken;
+
+/* A type of reader that returns json token by token when it's asked to. It keeps its position in a fixed amount
+ * of memory besides the longest string it has seen, so documents of any size can be walked through. */
+typedef struct LibjReader_ LibjReader;
+
+/* Create reader of single json value from input. input must outlive reader. */
+LibjError libj_reader_create(Libj *libj, LibisInputStream *input, LibjReader **reader);
+
+/* Create reader of single json value from buffer. buffer must outlive reader. Strings without escape sequences
+ * and numbers are returned right from buffer. */
+LibjError libj_reader_create_from_buffer(Libj *libj, const char *buffer, size_t buffer_size, LibjReader **reader);
+
+/* Release reader. *reader == NULL is allowed. */
+LibjError libj_reader_free(Libj *libj, LibjReader **reader);
+
+/* Read next token. LIBJ_TOKEN_END is returned from then on once the value is over. A reader that failed keeps
+ * returning the same error and message, the message stays valid until the reader is freed. */
+LibjError libj_reader_next(Libj *libj, LibjReader *reader, LibjToken *token, const char **error_string);
+
+/* Skip the value that comes next together with everything inside it, or the whole member if a member name comes
+ * next. Nothing is skipped at the end of an array or an object. Skipped arrays and objects are only checked for
+ * matching brackets and closed strings, which makes skipping them much cheaper than reading. */
+LibjError libj_reader_skip_value(Libj *libj, LibjReader *reader, const char **error_string);
+
+/* Whether a push parser has got the whole value. */
+typedef enum {
+    LIBJ_FEED_NEED_MORE,
+    LIBJ_FEED_DONE,
+} LibjFeedStatus;
+
+/* A type of parser that is given input chunk by chunk as it arrives, for example from a non-blocking socket,
+ * instead of reading it itself. Nesting is tracked on its own stack and strings and numbers may be split between
+ * chunks anywhere, so it never waits for input nor needs the whole of it at once. */
+typedef struct LibjPushParser_ LibjPushParser;
+
+/* Create push parser of single json value. */
+LibjError libj_push_parser_create(Libj *libj, LibjPushParser **parser);
+
+/* Release parser together with the part of json it has built. *parser == NULL is allowed. */
+LibjError libj_push_parser_free(Libj *libj, LibjPushParser **parser);
+
+/* Parse the next chunk of input. An empty chunk tells that input is over, which is needed to end a number at the
+ * top level that nothing follows. *status is LIBJ_FEED_DONE and *json is the parsed value once the value is
+ * complete. Bytes after the value are ignored, and so are chunks given to a parser that is done, *json is NULL for
+ * them. A parser that failed keeps returning the same error and message, the message stays valid until the parser is
+ * freed. */
+LibjError libj_feed(Libj *libj, LibjPushParser *parser, const char *chunk, size_t chunk_size,
+                    LibjFeedStatus *status, LibjJson **json, const char **error_string);
+
+/* Read the next record of newline-delimited json (NDJSON, JSON Lines) from input. Blank lines are skipped and
+ * *json is set to NULL once input is over. A record takes exactly one line, a value that goes on past the end of
+ * its line is a syntax error. *offset counts the bytes of input read so far, it must be 0 before the first call
+ * for input. Error messages tell the byte where the bad record starts. Buffers of the parser are kept in libj
+ * between calls, so reading many records costs little more than the values themselves. */
+LibjError libj_ndjson_next(Libj *libj, LibisInputStream *input, size_t *offset, LibjJson **json,
+                           const char **error_string);
+
+/* A type of writer of newline-delimited json. Records are written compact, each followed by '\n'. */
+typedef struct LibjNdjsonWriter_ LibjNdjsonWriter;
+
+/* Create writer that passes records to write in chunks that hold many records at once. */
+LibjError libj_ndjson_writer_create(Libj *libj, LibjWriteCallback write, void *user, LibjNdjsonWriter **writer);
+
+/* Release writer. Records that haven't been flushed are dropped. *writer == NULL is allowed. */
+LibjError libj_ndjson_writer_free(Libj *libj, LibjNdjsonWriter **writer);
+
+/* Append json as the next record. Returns LIBJ_ERROR_IO if write fails. */
+LibjError libj_ndjson_write(Libj *libj, LibjNdjsonWriter *writer, LibjJson *json);
+
+/* Pass records appended so far to write. */
+LibjError libj_ndjson_writer_flush(Libj *libj, LibjNdjsonWriter *writer);
+
+/* Receives records of newline-delimited json parsed in parallel. json is taken over by the callback and offset is
+ * where the record starts in input. Return false to stop parsing. */
+typedef bool (*LibjRecordCallback)(void *user, LibjJson *json, size_t offset);
+
+/* Parse newline-delimited json in buffer with threads worker threads, each with a context of its own, and pass
+ * the records to callback. threads == 0 means one per processor. callback is called on the calling thread only,
+ * in input order if ordered is set and as soon as records are ready otherwise. Input is split on newlines, records
+ * end with their lines as they do for libj_ndjson_next(). Records are allocated from the heap whatever the
+ * document of libj is, their member names aren't interned and typed numbers follow libj. Parsing stops at the first
+ * bad record after all records before it in input order have been passed on when ordered is set. Returns
+ * LIBJ_ERROR_STOPPED if the callback returns false. */
+LibjError libj_ndjson_parse_parallel(Libj *libj, const char *buffer, size_t buffer_size, size_t threads,
+                                     bool ordered, LibjRecordCallback callback, void *user,
+                                     const char **error_string);
+
+/* Same as libj_ndjson_parse_parallel() but input is the file at path mapped into memory. */
+LibjError libj_ndjson_parse_file(Libj *libj, const char *path, size_t threads, bool ordered,
+                                 LibjRecordCallback callback, void *user, const char **error_string);
+
+/* Make the parser keep numbers as int64_t or double instead of their text. Integers that fit into int64_t and
+ * other numbers of at most 19 significant digits within the range of normal doubles keep only the value. Anything
+ * else, as well as a few numbers that are hard to round correctly, keeps its text. libj_get_number() and
+ * serialization make text of such a number from its value, so it may differ from the input: 1.50 becomes 1.5 and
+ * 1e2 becomes 100. */
+LibjError libj_use_typed_numbers(Libj *libj, bool enable);
+
 #endif
 
@@ -0,0 +1,12 @@
+#ifndef LIBJ_ATOD_H
+#define LIBJ_ATOD_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/* Convert text of a json number into the nearest double without looking at the locale. Returns false for the
+ * rare inputs it can't convert exactly, such as ones with more than 19 significant digits or very close to a
+ * halfway point, which must be converted with strtod() instead. */
+bool libj_parse_double(const char *text, size_t size, double *value);
+
+#endif
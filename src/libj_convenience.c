@@ -19,7 +19,7 @@ LibjError libj_object_add_string(Libj *libj, LibjJson *json, const char *name, c
     }
     err = E(libj_string_create(libj, &json_value, value));
     if (err) goto end;
-    err = E(libj_object_add(libj, json, name, json_value));
+    err = E(libj_object_add_take(libj, json, name, &json_value));
     if (err) goto end;
 end:
     E(libj_free_json(libj, &json_value));
@@ -39,7 +39,7 @@ LibjError libj_object_add_integer(Libj *libj, LibjJson *json, const char *name,
     }
     err = E(libj_integer_create(libj, &json_value, value));
     if (err) goto end;
-    err = E(libj_object_add(libj, json, name, json_value));
+    err = E(libj_object_add_take(libj, json, name, &json_value));
     if (err) goto end;
 end:
     E(libj_free_json(libj, &json_value));
@@ -57,9 +57,9 @@ LibjError libj_object_add_real(Libj *libj, LibjJson *json, const char *name, dou
         err = LIBJ_ERROR_BAD_TYPE;
         goto end;
     }
-    err = E(libj_real_create(libj, &json_value, value));
+    err = libj_real_create(libj, &json_value, value);
     if (err) goto end;
-    err = E(libj_object_add(libj, json, name, json_value));
+    err = E(libj_object_add_take(libj, json, name, &json_value));
     if (err) goto end;
 end:
     E(libj_free_json(libj, &json_value));
@@ -79,7 +79,7 @@ LibjError libj_object_add_number(Libj *libj, LibjJson *json, const char *name, c
     }
     err = E(libj_number_create(libj, &json_value, value));
     if (err) goto end;
-    err = E(libj_object_add(libj, json, name, json_value));
+    err = E(libj_object_add_take(libj, json, name, &json_value));
     if (err) goto end;
 end:
     E(libj_free_json(libj, &json_value));
@@ -99,7 +99,7 @@ LibjError libj_object_add_bool(Libj *libj, LibjJson *json, const char *name, boo
     }
     err = E(libj_bool_create(libj, &json_value, value));
     if (err) goto end;
-    err = E(libj_object_add(libj, json, name, json_value));
+    err = E(libj_object_add_take(libj, json, name, &json_value));
     if (err) goto end;
 end:
     E(libj_free_json(libj, &json_value));
@@ -119,7 +119,7 @@ LibjError libj_object_add_null(Libj *libj, LibjJson *json, const char *name) {
     }
     err = E(libj_null_create(libj, &json_value));
     if (err) goto end;
-    err = E(libj_object_add(libj, json, name, json_value));
+    err = E(libj_object_add_take(libj, json, name, &json_value));
     if (err) goto end;
 end:
     E(libj_free_json(libj, &json_value));
@@ -153,6 +153,33 @@ end:
     return err;
 }
 
+LibjError libj_object_add_take(Libj *libj, LibjJson *json, const char *name, LibjJson **value) {
+    LibjError err = LIBJ_ERROR_OK;
+    if (!libj || !json || !name || !value || !*value) {
+        err = LIBJ_ERROR_BAD_ARGUMENT;
+        goto end;
+    }
+    err = E(libj_object_add_take_ex(libj, json, name, strlen(name), value));
+    if (err) goto end;
+end:
+    return err;
+}
+
+LibjError libj_object_add_take_ex(Libj *libj, LibjJson *json, const char *name, size_t name_size, LibjJson **value) {
+    LibjError err = LIBJ_ERROR_OK;
+    if (!libj || !json || !name || !value || !*value) {
+        err = LIBJ_ERROR_BAD_ARGUMENT;
+        goto end;
+    }
+    if (LIBJ_TYPE_OBJECT != json->type) {
+        err = LIBJ_ERROR_BAD_TYPE;
+        goto end;
+    }
+    err = E(libj_object_insert_at_take_ex(libj, json, json->object.size, name, name_size, value));
+end:
+    return err;
+}
+
 LibjError libj_object_count_versions(Libj *libj, LibjJson *json, const char *name, size_t *nversions) {
     if (!name) {
         return LIBJ_ERROR_BAD_ARGUMENT;
@@ -456,15 +483,12 @@ LibjError libj_object_get_ex(Libj *libj, LibjJson *json, LibjJson **value, const
         err = LIBJ_ERROR_BAD_TYPE;
         goto end;
     }
-    size_t number_of_versions;
-    err = E(libj_object_count_versions_ex(libj, json, name, name_size, &number_of_versions));
-    if (err) goto end;
-    if (!number_of_versions) {
+    size_t index;
+    if (!object_find_last_version(json, name, name_size, &index)) {
         err = LIBJ_ERROR_NOT_FOUND;
         goto end;
     }
-    err = E(libj_object_get_version_ex(libj, json, value, name, name_size, number_of_versions - 1));
-    if (err) goto end;
+    *value = json->object.members[index].value;
 end:
     return err;
 }
@@ -476,13 +500,13 @@ LibjError libj_object_set_null(Libj *libj, LibjJson *json, const char *name) {
         err = LIBJ_ERROR_BAD_ARGUMENT;
         goto end;
     }
-    if (LIBJ_TYPE_OBJECT == json->type) {
+    if (LIBJ_TYPE_OBJECT != json->type) {
         err = LIBJ_ERROR_BAD_TYPE;
         goto end;
     }
     err = E(libj_null_create(libj, &json_value));
     if (err) goto end;
-    err = E(libj_object_set(libj, json, name, json_value));
+    err = E(object_set_take(libj, json, name, strlen(name), &json_value));
     if (err) goto end;
 end:
     E(libj_free_json(libj, &json_value));
@@ -496,13 +520,13 @@ LibjError libj_object_set_bool(Libj *libj, LibjJson *json, const char *name, boo
         err = LIBJ_ERROR_BAD_ARGUMENT;
         goto end;
     }
-    if (LIBJ_TYPE_OBJECT == json->type) {
+    if (LIBJ_TYPE_OBJECT != json->type) {
         err = LIBJ_ERROR_BAD_TYPE;
         goto end;
     }
     err = E(libj_bool_create(libj, &json_value, value));
     if (err) goto end;
-    err = E(libj_object_set(libj, json, name, json_value));
+    err = E(object_set_take(libj, json, name, strlen(name), &json_value));
     if (err) goto end;
 end:
     E(libj_free_json(libj, &json_value));
@@ -516,13 +540,13 @@ LibjError libj_object_set_integer(Libj *libj, LibjJson *json, const char *name,
         err = LIBJ_ERROR_BAD_ARGUMENT;
         goto end;
     }
-    if (LIBJ_TYPE_OBJECT == json->type) {
+    if (LIBJ_TYPE_OBJECT != json->type) {
         err = LIBJ_ERROR_BAD_TYPE;
         goto end;
     }
     err = E(libj_integer_create(libj, &json_value, value));
     if (err) goto end;
-    err = E(libj_object_set(libj, json, name, json_value));
+    err = E(object_set_take(libj, json, name, strlen(name), &json_value));
     if (err) goto end;
 end:
     E(libj_free_json(libj, &json_value));
@@ -536,13 +560,13 @@ LibjError libj_object_set_real(Libj *libj, LibjJson *json, const char *name, dou
         err = LIBJ_ERROR_BAD_ARGUMENT;
         goto end;
     }
-    if (LIBJ_TYPE_OBJECT == json->type) {
+    if (LIBJ_TYPE_OBJECT != json->type) {
         err = LIBJ_ERROR_BAD_TYPE;
         goto end;
     }
-    err = E(libj_real_create(libj, &json_value, value));
+    err = libj_real_create(libj, &json_value, value);
     if (err) goto end;
-    err = E(libj_object_set(libj, json, name, json_value));
+    err = E(object_set_take(libj, json, name, strlen(name), &json_value));
     if (err) goto end;
 end:
     E(libj_free_json(libj, &json_value));
@@ -562,7 +586,7 @@ LibjError libj_object_set_string(Libj *libj, LibjJson *json, const char *name, c
     }
     err = E(libj_string_create(libj, &json_value, value));
     if (err) goto end;
-    err = E(libj_object_set(libj, json, name, json_value));
+    err = E(object_set_take(libj, json, name, strlen(name), &json_value));
     if (err) goto end;
 end:
     E(libj_free_json(libj, &json_value));
@@ -575,6 +599,7 @@ LibjError libj_object_set(Libj *libj, LibjJson *json, const char *name, LibjJson
 
 LibjError libj_object_set_ex(Libj *libj, LibjJson *json, const char *name, size_t name_size, LibjJson *value) {
     LibjError err = LIBJ_ERROR_OK;
+    LibjJson *value_copy = NULL;
     if (!libj || !json || !name || !value) {
         err = LIBJ_ERROR_BAD_ARGUMENT;
         goto end;
@@ -583,11 +608,12 @@ LibjError libj_object_set_ex(Libj *libj, LibjJson *json, const char *name, size_
         err = LIBJ_ERROR_BAD_TYPE;
         goto end;
     }
-    err = E(libj_object_remove_all_ex(libj, json, name, name_size));
+    err = E(json_copy(libj, json->document, value, &value_copy));
     if (err) goto end;
-    err = E(libj_object_add_ex(libj, json, name, name_size, value));
+    err = E(object_set_take(libj, json, name, name_size, &value_copy));
     if (err) goto end;
 end:
+    if (libj) E(libj_free_json(libj, &value_copy));
     return err;
 }
 
@@ -658,37 +684,8 @@ LibjError libj_object_remove_all_ex(Libj *libj, LibjJson *json, const char *name
         err = LIBJ_ERROR_BAD_TYPE;
         goto end;
     }
-    for (size_t i = 0; i < json->object.size; ++i) {
-        const char *member_name = json->object.members[i].name.value;
-        size_t member_name_size = json->object.members[i].name.size;
-        if (member_name_size == name_size && !memcmp(member_name, name, name_size)) {
-            err = E(libj_object_remove_at(libj, json, i));
-            if (err) goto end;
-        }
-    }
-end:
-    return err;
-}
-
-static LibjError array_add(LibjJson *json, LibjJson **element) {
-    LibjError err = LIBJ_ERROR_OK;
-    if (!json || !element || !*element) {
-        err = LIBJ_ERROR_BAD_ARGUMENT;
-        goto end;
-    }
-    if (LIBJ_TYPE_ARRAY != json->type) {
-        err = LIBJ_ERROR_BAD_TYPE;
-        goto end;
-    }
-    LibjJson **new_elements = realloc(json->array.elements, (json->array.size + 1) * sizeof(LibjJson *));
-    if (!new_elements) {
-        err = LIBJ_ERROR_OUT_OF_MEMORY;
-        goto end;
-    }
-    new_elements[json->array.size] = *element;
-    json->array.elements = new_elements;
-    ++json->array.size;
-    *element = NULL;
+    err = E(object_remove_versions(libj, json, name, name_size, NULL));
+    if (err) goto end;
 end:
     return err;
 }
@@ -702,7 +699,7 @@ LibjError libj_array_add_string(Libj *libj, LibjJson *json, const char *value) {
     }
     err = E(libj_string_create(libj, &json_value, value));
     if (err) goto end;
-    err = E(array_add(json, &json_value));
+    err = E(libj_array_add_take(libj, json, &json_value));
     if (err) goto end;
 end:
     E(libj_free_json(libj, &json_value));
@@ -718,7 +715,7 @@ LibjError libj_array_add_integer(Libj *libj, LibjJson *json, int64_t value) {
     }
     err = E(libj_integer_create(libj, &json_value, value));
     if (err) goto end;
-    err = E(array_add(json, &json_value));
+    err = E(libj_array_add_take(libj, json, &json_value));
     if (err) goto end;
 end:
     E(libj_free_json(libj, &json_value));
@@ -732,9 +729,9 @@ LibjError libj_array_add_real(Libj *libj, LibjJson *json, double value) {
         err = LIBJ_ERROR_BAD_ARGUMENT;
         goto end;
     }
-    err = E(libj_real_create(libj, &json_value, value));
+    err = libj_real_create(libj, &json_value, value);
     if (err) goto end;
-    err = E(array_add(json, &json_value));
+    err = E(libj_array_add_take(libj, json, &json_value));
     if (err) goto end;
 end:
     E(libj_free_json(libj, &json_value));
@@ -750,7 +747,7 @@ LibjError libj_array_add_number(Libj *libj, LibjJson *json, const char *value) {
     }
     err = E(libj_number_create(libj, &json_value, value));
     if (err) goto end;
-    err = E(array_add(json, &json_value));
+    err = E(libj_array_add_take(libj, json, &json_value));
     if (err) goto end;
 end:
     E(libj_free_json(libj, &json_value));
@@ -766,7 +763,7 @@ LibjError libj_array_add_bool(Libj *libj, LibjJson *json, bool value) {
     }
     err = E(libj_bool_create(libj, &json_value, value));
     if (err) goto end;
-    err = E(array_add(json, &json_value));
+    err = E(libj_array_add_take(libj, json, &json_value));
     if (err) goto end;
 end:
     E(libj_free_json(libj, &json_value));
@@ -775,7 +772,7 @@ end:
 
 LibjError libj_array_add_null(Libj *libj, LibjJson *json) {
     LibjError err = LIBJ_ERROR_OK;
-    LibjJson *json_value;
+    LibjJson *json_value = NULL;
     if (!libj || !json) {
         err = LIBJ_ERROR_BAD_ARGUMENT;
         goto end;
@@ -786,7 +783,7 @@ LibjError libj_array_add_null(Libj *libj, LibjJson *json) {
     }
     err = E(libj_null_create(libj, &json_value));
     if (err) goto end;
-    err = E(array_add(json, &json_value));
+    err = E(libj_array_add_take(libj, json, &json_value));
     if (err) goto end;
 end:
     E(libj_free_json(libj, &json_value));
@@ -0,0 +1,176 @@
+#include "libj_internal.h"
+
+#include <stdalign.h>
+#include <stddef.h>
+#include <string.h>
+
+/* Size of the first chunk of a document. Every next chunk is twice as large up to LIBJ_DOCUMENT_MAX_CHUNK_SIZE. */
+#define LIBJ_DOCUMENT_MIN_CHUNK_SIZE ((size_t) 4096)
+#define LIBJ_DOCUMENT_MAX_CHUNK_SIZE ((size_t) 16 * 1024 * 1024)
+
+typedef struct LibjDocumentChunk_ {
+    struct LibjDocumentChunk_ *previous;
+    size_t size;
+    size_t used;
+    alignas(max_align_t) unsigned char data[];
+} LibjDocumentChunk;
+
+/* Bump allocator. Allocations are served from the last chunk and are never released one by one. */
+struct LibjDocument_ {
+    LibjDocumentChunk *chunk;
+    size_t next_chunk_size;
+};
+
+static size_t align_size(size_t size) {
+    return (size + alignof(max_align_t) - 1) & ~(alignof(max_align_t) - 1);
+}
+
+static LibjDocumentChunk *chunk_create(size_t size) {
+    LibjDocumentChunk *chunk = malloc(sizeof(LibjDocumentChunk) + size);
+    if (!chunk) {
+        return NULL;
+    }
+    chunk->previous = NULL;
+    chunk->size = size;
+    chunk->used = 0;
+    return chunk;
+}
+
+LibjError libj_document_create(Libj *libj, LibjDocument **document) {
+    LibjError err = LIBJ_ERROR_OK;
+    LibjDocument *result = NULL;
+    if (!libj || !document) {
+        err = LIBJ_ERROR_BAD_ARGUMENT;
+        goto end;
+    }
+    result = malloc(sizeof(LibjDocument));
+    if (!result) {
+        err = LIBJ_ERROR_OUT_OF_MEMORY;
+        goto end;
+    }
+    result->chunk = NULL;
+    result->next_chunk_size = LIBJ_DOCUMENT_MIN_CHUNK_SIZE;
+    *document = result;
+    result = NULL;
+end:
+    free(result);
+    return err;
+}
+
+LibjError libj_document_free(Libj *libj, LibjDocument **document) {
+    LibjError err = LIBJ_ERROR_OK;
+    if (!libj || !document) {
+        err = LIBJ_ERROR_BAD_ARGUMENT;
+        goto end;
+    }
+    if (!*document) {
+        goto end;
+    }
+    if (libj->document == *document) {
+        libj->document = NULL;
+    }
+    LibjDocumentChunk *chunk = (*document)->chunk;
+    while (chunk) {
+        LibjDocumentChunk *previous = chunk->previous;
+        free(chunk);
+        chunk = previous;
+    }
+    free(*document);
+    *document = NULL;
+end:
+    return err;
+}
+
+LibjError libj_use_document(Libj *libj, LibjDocument *document) {
+    LibjError err = LIBJ_ERROR_OK;
+    if (!libj) {
+        err = LIBJ_ERROR_BAD_ARGUMENT;
+        goto end;
+    }
+    libj->document = document;
+end:
+    return err;
+}
+
+size_t libj_document_size(LibjDocument *document) {
+    size_t size = 0;
+    for (LibjDocumentChunk *chunk = document->chunk; chunk; chunk = chunk->previous) {
+        size += chunk->size;
+    }
+    return size;
+}
+
+void *libj_allocate(LibjDocument *document, size_t size) {
+    if (!document) {
+        return malloc(size ? size : 1);
+    }
+    size = align_size(size ? size : 1);
+    LibjDocumentChunk *chunk = document->chunk;
+    if (chunk && size <= chunk->size - chunk->used) {
+        void *memory = chunk->data + chunk->used;
+        chunk->used += size;
+        return memory;
+    }
+    if (size > document->next_chunk_size / 2) {
+        /* Big allocations get a chunk of their own that is put behind the current one so that the rest of the
+         * current chunk isn't wasted. */
+        LibjDocumentChunk *own = chunk_create(size);
+        if (!own) {
+            return NULL;
+        }
+        own->used = size;
+        if (chunk) {
+            own->previous = chunk->previous;
+            chunk->previous = own;
+        } else {
+            document->chunk = own;
+        }
+        return own->data;
+    }
+    LibjDocumentChunk *new_chunk = chunk_create(document->next_chunk_size);
+    if (!new_chunk) {
+        return NULL;
+    }
+    if (document->next_chunk_size < LIBJ_DOCUMENT_MAX_CHUNK_SIZE) {
+        document->next_chunk_size *= 2;
+    }
+    new_chunk->previous = chunk;
+    new_chunk->used = size;
+    document->chunk = new_chunk;
+    return new_chunk->data;
+}
+
+void *libj_reallocate(LibjDocument *document, void *memory, size_t size, size_t new_size) {
+    if (!document) {
+        return realloc(memory, new_size ? new_size : 1);
+    }
+    if (!memory) {
+        return libj_allocate(document, new_size);
+    }
+    LibjDocumentChunk *chunk = document->chunk;
+    size_t aligned_size = align_size(size ? size : 1);
+    size_t aligned_new_size = align_size(new_size ? new_size : 1);
+    if (chunk && (unsigned char *) memory + aligned_size == chunk->data + chunk->used) {
+        /* The last allocation of the chunk can be resized in place. */
+        size_t available = chunk->size - chunk->used + aligned_size;
+        if (aligned_new_size <= available) {
+            chunk->used = chunk->used - aligned_size + aligned_new_size;
+            return memory;
+        }
+    }
+    if (new_size <= size) {
+        return memory;
+    }
+    void *new_memory = libj_allocate(document, new_size);
+    if (!new_memory) {
+        return NULL;
+    }
+    memcpy(new_memory, memory, size);
+    return new_memory;
+}
+
+void libj_deallocate(LibjDocument *document, void *memory) {
+    if (!document) {
+        free(memory);
+    }
+}
@@ -0,0 +1,20 @@
+#ifndef LIBJ_DTOA_H
+#define LIBJ_DTOA_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Size of a buffer that is enough for any output of libj_format_double(). */
+#define LIBJ_DOUBLE_BUFFER_SIZE 32
+
+/* Write the shortest decimal representation of finite value that converts back into the same double. Output
+ * always uses '.' and is not null-terminated. Returns the number of bytes written. */
+size_t libj_format_double(double value, char *buffer);
+
+/* Number of bytes libj_format_integer() writes for value. It's at most 20. */
+size_t libj_integer_size(int64_t value);
+
+/* Write decimal representation of value which is not null-terminated. Returns the number of bytes written. */
+size_t libj_format_integer(int64_t value, char *buffer);
+
+#endif
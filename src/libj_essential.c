@@ -1,8 +1,11 @@
 #include "libj_internal.h"
 #include "libj_utils.h"
+#include "libj_atod.h"
+#include "libj_dtoa.h"
 
 #include <libutf.h>
 
+#include <math.h>
 #include <stdio.h>
 #include <string.h>
 
@@ -72,6 +75,8 @@ LibjError libj_handle_internal_error(LibjError err) {
             return LIBJ_ERROR_IO;
         case LIBJ_ERROR_ZERO:
             return LIBJ_ERROR_ZERO;
+        case LIBJ_ERROR_STOPPED:
+            return LIBJ_ERROR_STOPPED;
     }
     abort();
 }
@@ -97,12 +102,19 @@ LibjError libj_start(Libj **libj) {
     if (!libj_result) {
         goto end;
     }
+    libj_result->symbols = NULL;
+    libj_result->interning = false;
+    libj_result->typed_numbers = false;
+    libj_result->scratch.bytes = NULL;
+    libj_result->scratch.size = 0;
+    libj_result->scratch.capacity = 0;
     c_locale = newlocale(LC_ALL_MASK, "C", (locale_t) 0);
     if (c_locale == (locale_t) 0) {
         err = LIBJ_ERROR_IO;
         goto end;
     }
     libj_result->error_string = NULL;
+    libj_result->document = NULL;
     libj_result->libsb = libsb;
     libsb = NULL;
     libj_result->libgb = libgb;
@@ -131,11 +143,13 @@ LibjError libj_finish(Libj **libj) {
     if (!*libj) {
         goto end;
     }
+    symbol_table_free(*libj, &(*libj)->symbols);
     freelocale((*libj)->c_locale);
     EIS(libis_finish(&(*libj)->libis));
     ESB(libsb_finish(&(*libj)->libsb));
     EGB(libgb_finish(&(*libj)->libgb));
     free((*libj)->error_string);
+    free((*libj)->scratch.bytes);
     free(*libj);
     *libj = NULL;
 end:
@@ -186,6 +200,7 @@ static struct {
         {LIBJ_ERROR_SYNTAX,        "LIBJ_ERROR_SYNTAX",        "Syntax error"},
         {LIBJ_ERROR_IO,            "LIBJ_ERROR_IO",            "Input/output error"},
         {LIBJ_ERROR_ZERO,          "LIBJ_ERROR_ZERO",          "Value contains expected '\\0'"},
+        {LIBJ_ERROR_STOPPED,       "LIBJ_ERROR_STOPPED",       "Stopped by a callback"},
 };
 
 const char *libj_error_to_string(LibjError error) {
@@ -232,38 +247,47 @@ LibjError libj_free_json(Libj *libj, LibjJson **json) {
         err = LIBJ_ERROR_BAD_ARGUMENT;
         goto end;
     }
-    if (*json) {
-        switch ((*json)->type) {
-            case LIBJ_TYPE_NULL:
-                break;
-            case LIBJ_TYPE_STRING:
-            case LIBJ_TYPE_NUMBER:
-                free((*json)->string.value);
-                (*json)->string.value = NULL;
-                (*json)->string.size = 0;
-                break;
-            case LIBJ_TYPE_BOOL:
-                break;
-            case LIBJ_TYPE_ARRAY:
-                for (size_t i = 0; i < (*json)->array.size; ++i) {
-                    E(libj_free_json(libj, &(*json)->array.elements[i]));
-                    (*json)->array.elements[i] = NULL;
-                }
-                free((*json)->array.elements);
-                (*json)->array.elements = NULL;
-                (*json)->array.size = 0;
-                break;
-            case LIBJ_TYPE_OBJECT:
-                for (size_t i = 0; i < (*json)->object.size; ++i) {
-                    LibjMember *member = &(*json)->object.members[i];
-                    free(member->name.value);
-                    E(libj_free_json(libj, &member->value));
-                }
-                free((*json)->object.members);
-                (*json)->object.members = NULL;
-                (*json)->object.size = 0;
-                break;
-        }
+    if (!*json) {
+        goto end;
+    }
+    if ((*json)->document) {
+        /* Memory of json is released together with its document. */
+        *json = NULL;
+        goto end;
+    }
+    switch ((*json)->type) {
+        case LIBJ_TYPE_NULL:
+            break;
+        case LIBJ_TYPE_STRING:
+            string_release(NULL, &(*json)->string);
+            break;
+        case LIBJ_TYPE_NUMBER:
+            string_release(NULL, &(*json)->number.text);
+            break;
+        case LIBJ_TYPE_BOOL:
+            break;
+        case LIBJ_TYPE_ARRAY:
+            for (size_t i = 0; i < (*json)->array.size; ++i) {
+                E(libj_free_json(libj, &(*json)->array.elements[i]));
+                (*json)->array.elements[i] = NULL;
+            }
+            free((*json)->array.elements);
+            (*json)->array.elements = NULL;
+            (*json)->array.size = 0;
+            (*json)->array.capacity = 0;
+            break;
+        case LIBJ_TYPE_OBJECT:
+            for (size_t i = 0; i < (*json)->object.size; ++i) {
+                LibjMember *member = &(*json)->object.members[i];
+                string_release(NULL, &member->name);
+                E(libj_free_json(libj, &member->value));
+            }
+            object_index_free(*json);
+            free((*json)->object.members);
+            (*json)->object.members = NULL;
+            (*json)->object.size = 0;
+            (*json)->object.capacity = 0;
+            break;
     }
     free(*json);
     *json = NULL;
@@ -271,25 +295,104 @@ end:
     return err;
 }
 
-static LibjError copy_string(Libj *libj, LibjString src, LibjString *dest) {
+void string_release(LibjDocument *document, LibjString *string) {
+    if (LIBJ_STRING_OWNED == string->storage) {
+        libj_deallocate(document, string->value);
+    }
+    string->value = NULL;
+    string->size = 0;
+    string->storage = LIBJ_STRING_OWNED;
+}
+
+LibjError string_materialize(Libj *libj, LibjDocument *document, LibjString *string) {
     LibjError err = LIBJ_ERROR_OK;
-    if (!libj || !dest) {
+    char *value = NULL;
+    if (!libj || !string) {
         err = LIBJ_ERROR_BAD_ARGUMENT;
         goto end;
     }
-    dest->size = src.size;
-    dest->value = malloc(src.size + 1);
-    if (!dest->value) {
+    if (LIBJ_STRING_VIEW != string->storage) {
+        goto end;
+    }
+    err = E(libj_string_duplicate(libj, document, string->value, string->size, &value));
+    if (err) goto end;
+    string->value = value;
+    string->storage = LIBJ_STRING_OWNED;
+end:
+    return err;
+}
+
+LibjError json_create(Libj *libj, LibjDocument *document, LibjType type, LibjJson **json) {
+    LibjError err = LIBJ_ERROR_OK;
+    LibjJson *result = NULL;
+    if (!libj || !json) {
+        err = LIBJ_ERROR_BAD_ARGUMENT;
+        goto end;
+    }
+    result = libj_allocate(document, sizeof(LibjJson));
+    if (!result) {
         err = LIBJ_ERROR_OUT_OF_MEMORY;
         goto end;
     }
-    memcpy(dest->value, src.value, src.size);
-    dest->value[dest->size] = '\0';
+    result->type = type;
+    result->document = document;
+    switch (type) {
+        case LIBJ_TYPE_NULL:
+            break;
+        case LIBJ_TYPE_STRING:
+            result->string.size = 0;
+            result->string.value = NULL;
+            result->string.storage = LIBJ_STRING_OWNED;
+            break;
+        case LIBJ_TYPE_NUMBER:
+            result->number.text.size = 0;
+            result->number.text.value = NULL;
+            result->number.text.storage = LIBJ_STRING_OWNED;
+            result->number.decoded = 0;
+            break;
+        case LIBJ_TYPE_BOOL:
+            result->boolean = false;
+            break;
+        case LIBJ_TYPE_ARRAY:
+            result->array.size = 0;
+            result->array.capacity = 0;
+            result->array.elements = NULL;
+            break;
+        case LIBJ_TYPE_OBJECT:
+            result->object.size = 0;
+            result->object.capacity = 0;
+            result->object.members = NULL;
+            result->object.index = NULL;
+            break;
+        default:
+            abort();
+    }
+    *json = result;
+    result = NULL;
+end:
+    return err;
+}
+
+static LibjError copy_string(Libj *libj, LibjDocument *document, LibjString src, LibjString *dest) {
+    LibjError err = LIBJ_ERROR_OK;
+    if (!libj || !dest) {
+        err = LIBJ_ERROR_BAD_ARGUMENT;
+        goto end;
+    }
+    if (LIBJ_STRING_INTERNED == src.storage) {
+        /* Symbols are immutable and outlive every json, so the copy can share them. */
+        *dest = src;
+        goto end;
+    }
+    err = E(libj_string_duplicate(libj, document, src.value, src.size, &dest->value));
+    if (err) goto end;
+    dest->size = src.size;
+    dest->storage = LIBJ_STRING_OWNED;
 end:
     return err;
 }
 
-static LibjError copy_array(Libj *libj, LibjArray *source, LibjArray *target) {
+static LibjError copy_array(Libj *libj, LibjDocument *document, LibjArray *source, LibjArray *target) {
     LibjError err = LIBJ_ERROR_OK;
     LibjArray result;
     size_t number_of_copied = 0;
@@ -298,29 +401,34 @@ static LibjError copy_array(Libj *libj, LibjArray *source, LibjArray *target) {
         goto end;
     }
     result.size = source->size;
-    result.elements = malloc(source->size * sizeof(LibjJson *));
-    if (!result.elements) {
-        err = LIBJ_ERROR_OUT_OF_MEMORY;
-        goto end;
+    result.capacity = source->size;
+    result.elements = NULL;
+    if (source->size) {
+        result.elements = libj_allocate(document, source->size * sizeof(LibjJson *));
+        if (!result.elements) {
+            err = LIBJ_ERROR_OUT_OF_MEMORY;
+            goto end;
+        }
     }
     for (; number_of_copied < source->size; ++number_of_copied) {
-        err = E(libj_copy(libj, source->elements[number_of_copied], &result.elements[number_of_copied]));
+        err = E(json_copy(libj, document, source->elements[number_of_copied],
+                          &result.elements[number_of_copied]));
         if (err) goto end;
     }
     *target = result;
     result.size = 0;
+    result.capacity = 0;
     result.elements = NULL;
     number_of_copied = 0;
 end:
     for (; number_of_copied--;) {
-        free(result.elements[number_of_copied]);
         E(libj_free_json(libj, &result.elements[number_of_copied]));
     }
-    free(result.elements);
+    libj_deallocate(document, result.elements);
     return err;
 }
 
-static LibjError copy_object(Libj *libj, LibjObject *source, LibjObject *target) {
+static LibjError copy_object(Libj *libj, LibjDocument *document, LibjObject *source, LibjObject *target) {
     LibjError err = LIBJ_ERROR_OK;
     LibjObject result;
     size_t number_of_copied = 0;
@@ -329,65 +437,79 @@ static LibjError copy_object(Libj *libj, LibjObject *source, LibjObject *target)
         goto end;
     }
     result.size = source->size;
-    result.members = malloc(source->size * sizeof(LibjMember));
-    if (!result.members) {
-        err = LIBJ_ERROR_OUT_OF_MEMORY;
-        goto end;
+    result.capacity = source->size;
+    result.members = NULL;
+    result.index = NULL;
+    if (source->size) {
+        result.members = libj_allocate(document, source->size * sizeof(LibjMember));
+        if (!result.members) {
+            err = LIBJ_ERROR_OUT_OF_MEMORY;
+            goto end;
+        }
     }
     for (; number_of_copied < source->size; ++number_of_copied) {
-        err = E(copy_string(libj, source->members[number_of_copied].name, &result.members[number_of_copied].name));
-        if (err) goto end;
-        err = E(libj_copy(libj, source->members[number_of_copied].value, &result.members[number_of_copied].value));
+        LibjMember *member = &result.members[number_of_copied];
+        err = E(copy_string(libj, document, source->members[number_of_copied].name, &member->name));
         if (err) goto end;
+        err = E(json_copy(libj, document, source->members[number_of_copied].value, &member->value));
+        if (err) {
+            string_release(document, &member->name);
+            goto end;
+        }
     }
     *target = result;
     result.size = 0;
+    result.capacity = 0;
     result.members = NULL;
     number_of_copied = 0;
 end:
     for (; number_of_copied--;) {
-        free(result.members[number_of_copied].name.value);
+        string_release(document, &result.members[number_of_copied].name);
         E(libj_free_json(libj, &result.members[number_of_copied].value));
     }
-    free(result.members);
+    libj_deallocate(document, result.members);
     return err;
 }
 
-LibjError libj_copy(Libj *libj, LibjJson *source, LibjJson **target) {
+LibjError json_copy(Libj *libj, LibjDocument *document, LibjJson *source, LibjJson **target) {
     LibjError err = LIBJ_ERROR_OK;
     LibjJson *result = NULL;
     if (!libj || !source || !target) {
         err = LIBJ_ERROR_BAD_ARGUMENT;
         goto end;
     }
-    result = malloc(sizeof(LibjJson));
-    if (!result) {
-        err = LIBJ_ERROR_OUT_OF_MEMORY;
-        goto end;
-    }
-    result->type = source->type;
+    err = E(json_create(libj, document, LIBJ_TYPE_NULL, &result));
+    if (err) goto end;
     switch (source->type) {
         case LIBJ_TYPE_NULL:
             break;
         case LIBJ_TYPE_STRING:
+            err = E(copy_string(libj, document, source->string, &result->string));
+            if (err) goto end;
+            break;
         case LIBJ_TYPE_NUMBER:
-            err = E(copy_string(libj, source->string, &result->string));
+            result->number = source->number;
+            if (!source->number.text.value) {
+                break;
+            }
+            err = E(copy_string(libj, document, source->number.text, &result->number.text));
             if (err) goto end;
             break;
         case LIBJ_TYPE_BOOL:
             result->boolean = source->boolean;
             break;
         case LIBJ_TYPE_ARRAY:
-            err = E(copy_array(libj, &source->array, &result->array));
+            err = E(copy_array(libj, document, &source->array, &result->array));
             if (err) goto end;
             break;
         case LIBJ_TYPE_OBJECT:
-            err = E(copy_object(libj, &source->object, &result->object));
+            err = E(copy_object(libj, document, &source->object, &result->object));
             if (err) goto end;
             break;
         default:
             abort();
     }
+    result->type = source->type;
     *target = result;
     result = NULL;
 end:
@@ -395,25 +517,129 @@ end:
     return err;
 }
 
-LibjError libj_object_create(Libj *libj, LibjJson **json) {
+LibjError libj_copy(Libj *libj, LibjJson *source, LibjJson **target) {
     LibjError err = LIBJ_ERROR_OK;
-    LibjJson *result = NULL;
-    if (!libj || !json) {
+    if (!libj || !source || !target) {
         err = LIBJ_ERROR_BAD_ARGUMENT;
         goto end;
     }
-    result = malloc(sizeof(LibjJson));
-    if (!result) {
+    err = E(json_copy(libj, libj->document, source, target));
+    if (err) goto end;
+end:
+    return err;
+}
+
+/* Make *json allocated from document. If it's allocated elsewhere, it's replaced with a copy made in document.
+ * On failure *json is left untouched. */
+static LibjError json_move_to(Libj *libj, LibjDocument *document, LibjJson **json) {
+    LibjError err = LIBJ_ERROR_OK;
+    LibjJson *copy = NULL;
+    if (!libj || !json || !*json) {
+        err = LIBJ_ERROR_BAD_ARGUMENT;
+        goto end;
+    }
+    if ((*json)->document == document) {
+        goto end;
+    }
+    err = E(json_copy(libj, document, *json, &copy));
+    if (err) goto end;
+    E(libj_free_json(libj, json));
+    *json = copy;
+end:
+    return err;
+}
+
+/* Capacity that storage of a container grows to when it's full. */
+static size_t next_capacity(size_t capacity) {
+    return capacity ? 2 * capacity : 4;
+}
+
+static LibjError object_set_capacity(LibjDocument *document, LibjObject *object, size_t capacity) {
+    LibjError err = LIBJ_ERROR_OK;
+    if (!object || capacity < object->size) {
+        err = LIBJ_ERROR_BAD_ARGUMENT;
+        goto end;
+    }
+    if (SIZE_MAX / sizeof(LibjMember) < capacity) {
         err = LIBJ_ERROR_OUT_OF_MEMORY;
         goto end;
     }
-    result->type = LIBJ_TYPE_OBJECT;
-    result->object.size = 0;
-    result->object.members = NULL;
-    *json = result;
-    result = NULL;
+    if (!capacity) {
+        libj_deallocate(document, object->members);
+        object->members = NULL;
+        object->capacity = 0;
+        goto end;
+    }
+    LibjMember *new_members = libj_reallocate(document, object->members,
+                                              object->capacity * sizeof(LibjMember), capacity * sizeof(LibjMember));
+    if (!new_members) {
+        err = LIBJ_ERROR_OUT_OF_MEMORY;
+        goto end;
+    }
+    object->members = new_members;
+    object->capacity = capacity;
+end:
+    return err;
+}
+
+static LibjError array_set_capacity(LibjDocument *document, LibjArray *array, size_t capacity) {
+    LibjError err = LIBJ_ERROR_OK;
+    if (!array || capacity < array->size) {
+        err = LIBJ_ERROR_BAD_ARGUMENT;
+        goto end;
+    }
+    if (SIZE_MAX / sizeof(LibjJson *) < capacity) {
+        err = LIBJ_ERROR_OUT_OF_MEMORY;
+        goto end;
+    }
+    if (!capacity) {
+        libj_deallocate(document, array->elements);
+        array->elements = NULL;
+        array->capacity = 0;
+        goto end;
+    }
+    LibjJson **new_elements = libj_reallocate(document, array->elements,
+                                              array->capacity * sizeof(LibjJson *), capacity * sizeof(LibjJson *));
+    if (!new_elements) {
+        err = LIBJ_ERROR_OUT_OF_MEMORY;
+        goto end;
+    }
+    array->elements = new_elements;
+    array->capacity = capacity;
+end:
+    return err;
+}
+
+LibjError libj_shrink_to_fit(Libj *libj, LibjJson *json) {
+    LibjError err = LIBJ_ERROR_OK;
+    if (!libj || !json) {
+        err = LIBJ_ERROR_BAD_ARGUMENT;
+        goto end;
+    }
+    switch (json->type) {
+    case LIBJ_TYPE_ARRAY:
+        err = E(array_set_capacity(json->document, &json->array, json->array.size));
+        break;
+    case LIBJ_TYPE_OBJECT:
+        err = E(object_set_capacity(json->document, &json->object, json->object.size));
+        break;
+    default:
+        err = LIBJ_ERROR_BAD_TYPE;
+        break;
+    }
+end:
+    return err;
+}
+
+LibjError libj_object_create(Libj *libj, LibjJson **json) {
+    LibjError err = LIBJ_ERROR_OK;
+    if (!libj || !json) {
+        err = LIBJ_ERROR_BAD_ARGUMENT;
+        goto end;
+    }
+    err = E(json_create(libj, libj->document, LIBJ_TYPE_OBJECT, json));
+    if (err) goto end;
 end:
-    free(result);
     return err;
 }
 
@@ -429,21 +655,13 @@ LibjError libj_object_count_versions_ex(
         err = LIBJ_ERROR_BAD_TYPE;
         goto end;
     }
-    size_t count = 0;
-    for (size_t i = 0; i < json->object.size; ++i) {
-        const char *member_name = json->object.members[i].name.value;
-        size_t member_name_size = json->object.members[i].name.size;
-        if (member_name_size == name_size && !memcmp(member_name, name, name_size)) {
-            ++count;
-        }
-    }
-    *nversions = count;
+    *nversions = object_count_versions(json, name, name_size);
 end:
     return err;
 }
 
 LibjError object_get_version_index_ex(
-        LibjJson *json, const char *name, size_t name_size, int version, size_t *index) {
+        LibjJson *json, const char *name, size_t name_size, size_t version, size_t *index) {
     LibjError err = LIBJ_ERROR_OK;
     if (!json || !name || !index) {
         err = LIBJ_ERROR_BAD_ARGUMENT;
@@ -453,19 +671,9 @@ LibjError object_get_version_index_ex(
         err = LIBJ_ERROR_BAD_TYPE;
         goto end;
     }
-    *index = 0;
-    int count_versions_before_i = 0;
-    for (size_t i = 0; i < json->object.size; ++i) {
-        const char *member_name = json->object.members[i].name.value;
-        size_t member_name_size = json->object.members[i].name.size;
-        bool same_name = member_name_size == name_size && !memcmp(member_name, name, name_size);
-        if (same_name && count_versions_before_i == version) {
-            *index = i;
-            break;
-        }
-        if (same_name) {
-            ++count_versions_before_i;
-        }
+    if (!object_find_version(json, name, name_size, version, index)) {
+        err = LIBJ_ERROR_NOT_FOUND;
+        goto end;
     }
 end:
     return err;
@@ -491,10 +699,68 @@ end:
     return err;
 }
 
+LibjError libj_object_get_symbol(Libj *libj, LibjJson *json, const LibjSymbol *symbol, LibjJson **value) {
+    LibjError err = LIBJ_ERROR_OK;
+    if (!libj || !json || !symbol || !value) {
+        err = LIBJ_ERROR_BAD_ARGUMENT;
+        goto end;
+    }
+    *value = NULL;
+    if (LIBJ_TYPE_OBJECT != json->type) {
+        err = LIBJ_ERROR_BAD_TYPE;
+        goto end;
+    }
+    size_t index;
+    if (!object_find_last_symbol(json, symbol, &index)) {
+        err = LIBJ_ERROR_NOT_FOUND;
+        goto end;
+    }
+    *value = json->object.members[index].value;
+end:
+    return err;
+}
+
+LibjError object_insert_at_take(Libj *libj, LibjJson *json, size_t position, LibjString *name, LibjJson **value) {
+    LibjError err = LIBJ_ERROR_OK;
+    if (!libj || !json || !name || !name->value || !value || !*value) {
+        err = LIBJ_ERROR_BAD_ARGUMENT;
+        goto end;
+    }
+    if (LIBJ_TYPE_OBJECT != json->type) {
+        err = LIBJ_ERROR_BAD_TYPE;
+        goto end;
+    }
+    if (json->object.size < position) {
+        err = LIBJ_ERROR_NOT_FOUND;
+        goto end;
+    }
+    if (json->object.size == json->object.capacity) {
+        err = E(object_set_capacity(json->document, &json->object, next_capacity(json->object.capacity)));
+        if (err) goto end;
+    }
+    err = E(json_move_to(libj, json->document, value));
+    if (err) goto end;
+    LibjMember *members = json->object.members;
+    bool append = position == json->object.size;
+    memmove(&members[position + 1], &members[position], (json->object.size - position) * sizeof(LibjMember));
+    members[position].name = *name;
+    members[position].value = *value;
+    ++json->object.size;
+    if (append) {
+        object_index_appended(json);
+    } else {
+        object_index_invalidate(json);
+    }
+    name->value = NULL;
+    name->size = 0;
+    *value = NULL;
+end:
+    return err;
+}
+
 LibjError libj_object_insert_at_ex(
         Libj *libj, LibjJson *json, size_t position, const char *name, size_t name_size, LibjJson *value) {
     LibjError err = LIBJ_ERROR_OK;
-    char *name_copy = NULL;
     LibjJson *value_copy = NULL;
     if (!libj || !json || !name || !value) {
         err = LIBJ_ERROR_BAD_ARGUMENT;
@@ -504,30 +770,44 @@ LibjError libj_object_insert_at_ex(
         err = LIBJ_ERROR_BAD_TYPE;
         goto end;
     }
+    err = E(json_copy(libj, json->document, value, &value_copy));
+    if (err) goto end;
+    err = E(libj_object_insert_at_take_ex(libj, json, position, name, name_size, &value_copy));
+    if (err) goto end;
+end:
+    E(libj_free_json(libj, &value_copy));
+    return err;
+}
+
+LibjError libj_object_insert_at_take_ex(
+        Libj *libj, LibjJson *json, size_t position, const char *name, size_t name_size, LibjJson **value) {
+    LibjError err = LIBJ_ERROR_OK;
+    LibjString name_copy = { 0, NULL, LIBJ_STRING_OWNED };
+    if (!libj || !json || !name || !value || !*value) {
+        err = LIBJ_ERROR_BAD_ARGUMENT;
+        goto end;
+    }
+    if (LIBJ_TYPE_OBJECT != json->type) {
+        err = LIBJ_ERROR_BAD_TYPE;
+        goto end;
+    }
     if (json->object.size < position) {
         err = LIBJ_ERROR_NOT_FOUND;
         goto end;
     }
-    err = E(libj_string_duplicate(libj, name, name_size, &name_copy));
-    if (err) goto end;
-    err = E(libj_copy(libj, value, &value_copy));
-    if (err) goto end;
-    LibjMember *new_members = realloc(json->object.members, (json->object.size + 1) * sizeof(LibjMember));
-    if (!new_members) {
-        err = LIBJ_ERROR_OUT_OF_MEMORY;
-        goto end;
+    if (libj->interning) {
+        err = E(string_intern(libj, name, name_size, &name_copy));
+        if (err) goto end;
     }
-    memmove(&new_members[position + 1], &new_members[position], (json->object.size - position) * sizeof(LibjMember));
-    new_members[position].name.value = name_copy;
-    new_members[position].name.size = name_size;
-    new_members[position].value = value_copy;
-    ++json->object.size;
-    json->object.members = new_members;
-    name_copy = NULL;
-    value_copy = NULL;
+    if (!name_copy.value) {
+        err = E(libj_string_duplicate(libj, json->document, name, name_size, &name_copy.value));
+        if (err) goto end;
+        name_copy.size = name_size;
+    }
+    err = E(object_insert_at_take(libj, json, position, &name_copy, value));
+    if (err) goto end;
 end:
-    free(name_copy);
-    E(libj_free_json(libj, &value_copy));
+    if (json) string_release(json->document, &name_copy);
     return err;
 }
 
@@ -547,6 +827,25 @@ end:
     return err;
 }
 
+LibjError libj_object_reserve(Libj *libj, LibjJson *json, size_t capacity) {
+    LibjError err = LIBJ_ERROR_OK;
+    if (!libj || !json) {
+        err = LIBJ_ERROR_BAD_ARGUMENT;
+        goto end;
+    }
+    if (LIBJ_TYPE_OBJECT != json->type) {
+        err = LIBJ_ERROR_BAD_TYPE;
+        goto end;
+    }
+    if (capacity <= json->object.capacity) {
+        goto end;
+    }
+    err = E(object_set_capacity(json->document, &json->object, capacity));
+    if (err) goto end;
+end:
+    return err;
+}
+
 LibjError
 libj_object_get_member_at_ex(Libj *libj, LibjJson *json, size_t i, const char **name, size_t *name_size, LibjJson **value) {
     LibjError err = LIBJ_ERROR_OK;
@@ -565,6 +864,8 @@ libj_object_get_member_at_ex(Libj *libj, LibjJson *json, size_t i, const char **
         err = LIBJ_ERROR_NOT_FOUND;
         goto end;
     }
+    err = E(string_materialize(libj, json->document, &json->object.members[i].name));
+    if (err) goto end;
     LibjMember member = json->object.members[i];
     *name = member.name.value;
     *name_size = member.name.size;
@@ -588,43 +889,88 @@ LibjError libj_object_remove_at(Libj *libj, LibjJson *json, size_t index) {
         goto end;
     }
     LibjMember member_to_remove = json->object.members[index];
+    object_index_removed(json, index);
     void *dst = &json->object.members[index];
     void *src = &json->object.members[index + 1];
     size_t number_of_bytes = sizeof(LibjMember) * (json->object.size - index - 1);
     memmove(dst, src, number_of_bytes);
     --json->object.size;
-    LibjMember *new_members = realloc(json->object.members, sizeof(LibjMember) * json->object.size);
-    if (!new_members && json->object.size) {
-        ++json->object.size;
-        dst = &json->object.members[index + 1];
-        src = &json->object.members[index];
-        number_of_bytes = sizeof(LibjMember) * (json->object.size - index - 1);
-        memmove(dst, src, number_of_bytes);
-        json->object.members[index] = member_to_remove;
-        err = LIBJ_ERROR_OUT_OF_MEMORY;
+    E(libj_free_json(libj, &member_to_remove.value));
+    string_release(json->document, &member_to_remove.name);
+end:
+    return err;
+}
+
+LibjError object_remove_versions(Libj *libj, LibjJson *json, const char *name, size_t name_size, size_t *keep) {
+    LibjError err = LIBJ_ERROR_OK;
+    if (!libj || !json || !name) {
+        err = LIBJ_ERROR_BAD_ARGUMENT;
         goto end;
     }
-    json->object.members = new_members;
-    E(libj_free_json(libj, &member_to_remove.value));
-    free(member_to_remove.name.value);
+    if (LIBJ_TYPE_OBJECT != json->type) {
+        err = LIBJ_ERROR_BAD_TYPE;
+        goto end;
+    }
+    LibjMember *members = json->object.members;
+    size_t kept = 0;
+    for (size_t i = 0; i < json->object.size; ++i) {
+        LibjMember *member = &members[i];
+        bool same_name = member->name.size == name_size && !memcmp(member->name.value, name, name_size);
+        if (same_name && (!keep || *keep != i)) {
+            E(libj_free_json(libj, &member->value));
+            string_release(json->document, &member->name);
+            continue;
+        }
+        if (keep && *keep == i) {
+            *keep = kept;
+        }
+        members[kept++] = *member;
+    }
+    if (kept != json->object.size) {
+        json->object.size = kept;
+        object_index_invalidate(json);
+    }
 end:
     return err;
 }
 
-LibjError libj_array_create(Libj *libj, LibjJson **json) {
+LibjError object_set_take(Libj *libj, LibjJson *json, const char *name, size_t name_size, LibjJson **value) {
     LibjError err = LIBJ_ERROR_OK;
-    if (!libj || !json) {
+    if (!libj || !json || !name || !value || !*value) {
         err = LIBJ_ERROR_BAD_ARGUMENT;
         goto end;
     }
-    *json = malloc(sizeof(LibjJson));
-    if (!*json) {
-        err = LIBJ_ERROR_OUT_OF_MEMORY;
+    if (LIBJ_TYPE_OBJECT != json->type) {
+        err = LIBJ_ERROR_BAD_TYPE;
+        goto end;
+    }
+    size_t index;
+    if (!object_find_last_version(json, name, name_size, &index)) {
+        err = E(libj_object_insert_at_take_ex(libj, json, json->object.size, name, name_size, value));
+        goto end;
+    }
+    err = E(json_move_to(libj, json->document, value));
+    if (err) goto end;
+    if (1 < object_count_versions(json, name, name_size)) {
+        err = E(object_remove_versions(libj, json, name, name_size, &index));
+        if (err) goto end;
+    }
+    LibjMember *member = &json->object.members[index];
+    E(libj_free_json(libj, &member->value));
+    member->value = *value;
+    *value = NULL;
+end:
+    return err;
+}
+
+LibjError libj_array_create(Libj *libj, LibjJson **json) {
+    LibjError err = LIBJ_ERROR_OK;
+    if (!libj || !json) {
+        err = LIBJ_ERROR_BAD_ARGUMENT;
         goto end;
     }
-    (*json)->type = LIBJ_TYPE_ARRAY;
-    (*json)->array.size = 0;
-    (*json)->array.elements = NULL;
+    err = E(json_create(libj, libj->document, LIBJ_TYPE_ARRAY, json));
+    if (err) goto end;
 end:
     return err;
 }
@@ -640,19 +986,35 @@ LibjError libj_array_add(Libj *libj, LibjJson *json, LibjJson *element) {
         err = LIBJ_ERROR_BAD_TYPE;
         goto end;
     }
-    err = E(libj_copy(libj, element, &element_copy));
+    err = E(json_copy(libj, json->document, element, &element_copy));
     if (err) goto end;
-    LibjJson **new_elements = realloc(json->array.elements, (json->array.size + 1) * sizeof(LibjJson *));
-    if (!new_elements) {
-        err = LIBJ_ERROR_OUT_OF_MEMORY;
+    err = E(libj_array_add_take(libj, json, &element_copy));
+    if (err) goto end;
+end:
+    E(libj_free_json(libj, &element_copy));
+    return err;
+}
+
+LibjError libj_array_add_take(Libj *libj, LibjJson *json, LibjJson **element) {
+    LibjError err = LIBJ_ERROR_OK;
+    if (!libj || !json || !element || !*element) {
+        err = LIBJ_ERROR_BAD_ARGUMENT;
+        goto end;
+    }
+    if (LIBJ_TYPE_ARRAY != json->type) {
+        err = LIBJ_ERROR_BAD_TYPE;
         goto end;
     }
-    json->array.elements = new_elements;
-    json->array.elements[json->array.size] = element_copy;
+    if (json->array.size == json->array.capacity) {
+        err = E(array_set_capacity(json->document, &json->array, next_capacity(json->array.capacity)));
+        if (err) goto end;
+    }
+    err = E(json_move_to(libj, json->document, element));
+    if (err) goto end;
+    json->array.elements[json->array.size] = *element;
     ++json->array.size;
-    element_copy = NULL;
+    *element = NULL;
 end:
-    E(libj_free_json(libj, &element_copy));
     return err;
 }
 
@@ -672,6 +1034,25 @@ end:
     return err;
 }
 
+LibjError libj_array_reserve(Libj *libj, LibjJson *json, size_t capacity) {
+    LibjError err = LIBJ_ERROR_OK;
+    if (!libj || !json) {
+        err = LIBJ_ERROR_BAD_ARGUMENT;
+        goto end;
+    }
+    if (LIBJ_TYPE_ARRAY != json->type) {
+        err = LIBJ_ERROR_BAD_TYPE;
+        goto end;
+    }
+    if (capacity <= json->array.capacity) {
+        goto end;
+    }
+    err = E(array_set_capacity(json->document, &json->array, capacity));
+    if (err) goto end;
+end:
+    return err;
+}
+
 LibjError libj_array_get_element_at(Libj *libj, LibjJson *json, size_t i, LibjJson **element) {
     LibjError err = LIBJ_ERROR_OK;
     if (!libj || !json || !element) {
@@ -712,19 +1093,183 @@ LibjError libj_array_remove_at(Libj *libj, LibjJson *json, size_t index) {
     size_t number_of_bytes = sizeof(LibjJson *) * (json->array.size - index - 1);
     memmove(dst, src, number_of_bytes);
     --json->array.size;
-    LibjJson **new_elements = realloc(json->array.elements, sizeof(LibjJson *) * json->array.size);
-    if (!new_elements && json->array.size) {
-        ++json->array.size;
-        dst = &json->array.elements[index + 1];
-        src = &json->array.elements[index];
-        number_of_bytes = sizeof(LibjJson *) * (json->array.size - index - 1);
-        memmove(dst, src, number_of_bytes);
-        json->array.elements[index] = json_to_remove;
-        err = LIBJ_ERROR_OUT_OF_MEMORY;
+    E(libj_free_json(libj, &json_to_remove));
+end:
+    return err;
+}
+
+size_t number_format(const LibjNumber *number, char *buffer) {
+    if (number->decoded & LIBJ_NUMBER_REAL_VALUE) {
+        return libj_format_double(number->real, buffer);
+    }
+    return libj_format_integer(number->integer, buffer);
+}
+
+/* Convert text of a json number into int64_t exactly. Returns false if it's not an integer or doesn't fit. Text
+ * must follow json grammar. */
+static bool decode_integer(const char *text, size_t size, int64_t *value) {
+    const char *p = text;
+    const char *end = text + size;
+    bool negative = '-' == *p;
+    if (negative) {
+        ++p;
+    }
+    /* Number is magnitude * 10^(zeros - fraction_size + exponent). Zeros are held back until a non-zero digit
+     * follows them, so magnitude has no trailing zeros and a negative power means a fraction. */
+    uint64_t magnitude = 0;
+    int64_t zeros = 0;
+    int64_t fraction_size = 0;
+    bool fraction = false;
+    for (; p != end && 'e' != *p && 'E' != *p; ++p) {
+        if ('.' == *p) {
+            fraction = true;
+            continue;
+        }
+        fraction_size += fraction;
+        if ('0' == *p) {
+            ++zeros;
+            continue;
+        }
+        for (; 0 <= zeros; --zeros) {
+            if (UINT64_MAX / 10 < magnitude) {
+                return false;
+            }
+            magnitude *= 10;
+        }
+        zeros = 0;
+        if (UINT64_MAX - (*p - '0') < magnitude) {
+            return false;
+        }
+        magnitude += *p - '0';
+    }
+    int64_t exponent = 0;
+    if (p != end) {
+        ++p;
+        bool negative_exponent = '-' == *p;
+        if ('-' == *p || '+' == *p) {
+            ++p;
+        }
+        for (; p != end; ++p) {
+            /* Anything bigger doesn't fit and anything smaller isn't an integer unless magnitude is zero. */
+            if (exponent < 1000000) {
+                exponent = 10 * exponent + (*p - '0');
+            }
+        }
+        if (negative_exponent) {
+            exponent = -exponent;
+        }
+    }
+    if (!magnitude) {
+        *value = 0;
+        return true;
+    }
+    for (int64_t power = zeros - fraction_size + exponent; power; --power) {
+        if (power < 0 || UINT64_MAX / 10 < magnitude) {
+            return false;
+        }
+        magnitude *= 10;
+    }
+    if (magnitude > (uint64_t) INT64_MAX + negative) {
+        return false;
+    }
+    *value = negative ? (int64_t) (0 - magnitude) : (int64_t) magnitude;
+    return true;
+}
+
+/* Convert text of number into double. text is NULL for a number without text. */
+static LibjError decode_real(Libj *libj, LibjNumber *number, const char *text, size_t text_size) {
+    LibjError err = LIBJ_ERROR_OK;
+    char buffer[128];
+    char *copy = buffer;
+    if (!libj || !number) {
+        err = LIBJ_ERROR_BAD_ARGUMENT;
         goto end;
     }
-    json->array.elements = new_elements;
-    E(libj_free_json(libj, &json_to_remove));
+    if (number->decoded & LIBJ_NUMBER_REAL_DECODED) {
+        goto end;
+    }
+    /* Conversion of an integer rounds correctly just like conversion of its digits. Only -0 needs its text. */
+    bool integer_exact = number->decoded & LIBJ_NUMBER_INTEGER_EXACT;
+    if (!text || (integer_exact && (number->integer || '-' != *text))) {
+        number->real = (double) number->integer;
+        number->decoded |= LIBJ_NUMBER_REAL_DECODED | LIBJ_NUMBER_REAL_EXACT;
+        goto end;
+    }
+    double real;
+    if (libj_parse_double(text, text_size, &real)) {
+        number->real = real;
+        number->decoded |= LIBJ_NUMBER_REAL_DECODED | LIBJ_NUMBER_REAL_EXACT;
+        goto end;
+    }
+    /* Only the inputs the fast conversion gives up on are copied to be null-terminated. */
+    if (sizeof(buffer) <= text_size) {
+        copy = malloc(text_size + 1);
+        if (!copy) {
+            err = LIBJ_ERROR_OUT_OF_MEMORY;
+            goto end;
+        }
+    }
+    memcpy(copy, text, text_size);
+    copy[text_size] = '\0';
+    char *endptr;
+    real = strtod_l(copy, &endptr, libj->c_locale);
+    if (endptr != copy + text_size) {
+        err = LIBJ_ERROR_SYNTAX;
+        goto end;
+    }
+    /* Overflow gives infinity and underflow gives zero for a number that isn't zero. */
+    bool exact = !isinf(real);
+    if (0 == real) {
+        for (const char *p = copy; p != endptr && 'e' != *p && 'E' != *p; ++p) {
+            if ('1' <= *p && *p <= '9') {
+                exact = false;
+                break;
+            }
+        }
+    }
+    number->real = real;
+    number->decoded |= LIBJ_NUMBER_REAL_DECODED | (exact ? LIBJ_NUMBER_REAL_EXACT : 0);
+end:
+    if (copy != buffer) {
+        free(copy);
+    }
+    return err;
+}
+
+LibjError number_decode(Libj *libj, LibjNumber *number, const char *text, size_t text_size) {
+    LibjError err = LIBJ_ERROR_OK;
+    if (!libj || !number) {
+        err = LIBJ_ERROR_BAD_ARGUMENT;
+        goto end;
+    }
+    if (number->decoded & LIBJ_NUMBER_INTEGER_DECODED) {
+        err = E(decode_real(libj, number, text, text_size));
+        goto end;
+    }
+    int64_t integer;
+    if (text && decode_integer(text, text_size, &integer)) {
+        number->integer = integer;
+        number->decoded |= LIBJ_NUMBER_INTEGER_DECODED | LIBJ_NUMBER_INTEGER_EXACT;
+        err = E(decode_real(libj, number, text, text_size));
+        goto end;
+    }
+    /* The closest integer is the real value rounded toward zero and clamped. */
+    err = E(decode_real(libj, number, text, text_size));
+    if (err) goto end;
+    double real = number->real;
+    if (isnan(real)) {
+        integer = 0;
+    } else if (real <= (double) INT64_MIN) {
+        integer = INT64_MIN;
+    } else if ((double) INT64_MAX <= real) {
+        integer = INT64_MAX;
+    } else {
+        integer = (int64_t) real;
+    }
+    /* Without text the real value is all there is, so it's exact when it's integral. */
+    bool exact = !text && (double) integer == real && real < 9223372036854775808.0;
+    number->integer = integer;
+    number->decoded |= LIBJ_NUMBER_INTEGER_DECODED | (exact ? LIBJ_NUMBER_INTEGER_EXACT : 0);
 end:
     return err;
 }
@@ -740,11 +1285,9 @@ LibjError libj_get_integer(Libj *libj, LibjJson *json, int64_t *value) {
         err = LIBJ_ERROR_BAD_TYPE;
         goto end;
     }
-    *value = 0;
-    char *endptr;
-    *value = strtoimax(json->string.value, &endptr, 10);
-    if (endptr != json->string.value + json->string.size) {
-        err = LIBJ_ERROR_SYNTAX;
+    *value = json->number.integer;
+    if (!(json->number.decoded & LIBJ_NUMBER_INTEGER_EXACT)) {
+        err = LIBJ_ERROR_PRECISION;
         goto end;
     }
 end:
@@ -757,15 +1300,14 @@ LibjError libj_get_real(Libj *libj, LibjJson *json, double *value) {
         err = LIBJ_ERROR_BAD_ARGUMENT;
         goto end;
     }
+    *value = 0;
     if (LIBJ_TYPE_NUMBER != json->type) {
         err = LIBJ_ERROR_BAD_TYPE;
         goto end;
     }
-    *value = 0;
-    char *endptr;
-    *value = strtod(json->string.value, &endptr);
-    if (endptr != json->string.value + json->string.size) {
-        err = LIBJ_ERROR_SYNTAX;
+    *value = json->number.real;
+    if (!(json->number.decoded & LIBJ_NUMBER_REAL_EXACT)) {
+        err = LIBJ_ERROR_PRECISION;
         goto end;
     }
 end:
@@ -783,7 +1325,16 @@ LibjError libj_get_number(Libj *libj, LibjJson *json, char **value) {
         err = LIBJ_ERROR_BAD_TYPE;
         goto end;
     }
-    *value = json->string.value;
+    LibjNumber *number = &json->number;
+    if (!number->text.value) {
+        /* Text is made in libj rather than stored in json so that reading json doesn't change it. */
+        libj->number_text[number_format(number, libj->number_text)] = '\0';
+        *value = libj->number_text;
+        goto end;
+    }
+    err = E(string_materialize(libj, json->document, &number->text));
+    if (err) goto end;
+    *value = number->text.value;
 end:
     return err;
 }
@@ -816,6 +1367,8 @@ LibjError libj_get_string_ex(Libj *libj, LibjJson *json, char **value, size_t *v
         err = LIBJ_ERROR_BAD_TYPE;
         goto end;
     }
+    err = E(string_materialize(libj, json->document, &json->string));
+    if (err) goto end;
     *value = json->string.value;
     *value_size = json->string.size;
 end:
@@ -825,89 +1378,94 @@ end:
 LibjError libj_string_create_ex(Libj *libj, LibjJson **json, const char *value, size_t value_size) {
     LibjError err = LIBJ_ERROR_OK;
     LibjJson *result = NULL;
-    char *value_copy = NULL;
     if (!libj || !json || !value) {
         err = LIBJ_ERROR_BAD_ARGUMENT;
         goto end;
     }
-    result = malloc(sizeof(LibjJson));
-    if (!result) {
-        err = LIBJ_ERROR_OUT_OF_MEMORY;
-        goto end;
-    }
-    err = E(libj_string_duplicate(libj, value, value_size, &value_copy));
+    err = E(json_create(libj, libj->document, LIBJ_TYPE_STRING, &result));
+    if (err) goto end;
+    err = E(libj_string_duplicate(libj, libj->document, value, value_size, &result->string.value));
     if (err) goto end;
-    result->type = LIBJ_TYPE_STRING;
     result->string.size = value_size;
-    result->string.value = value_copy;
     *json = result;
     result = NULL;
-    value_copy = NULL;
 end:
-    free(result);
-    free(value_copy);
+    if (libj) E(libj_free_json(libj, &result));
     return err;
 }
 
-LibjError libj_integer_create(Libj *libj, LibjJson **json, int64_t value) {
+/* Create json number from its textual representation which must be valid. */
+static LibjError number_create(Libj *libj, LibjJson **json, const char *value, size_t value_size) {
     LibjError err = LIBJ_ERROR_OK;
     LibjJson *result = NULL;
-    LibsbBuilder *builder = NULL;
-    if (!libj || !json) {
+    if (!libj || !json || !value) {
         err = LIBJ_ERROR_BAD_ARGUMENT;
         goto end;
     }
-    result = malloc(sizeof(LibjJson));
-    if (!result) {
-        err = LIBJ_ERROR_OUT_OF_MEMORY;
-        goto end;
-    }
-    err = ESB(libsb_create(libj->libsb, &builder));
-    if (err) goto end;
-    err = ESB(libsb_append(libj->libsb, builder, "%"PRIiMAX, value));
+    err = E(json_create(libj, libj->document, LIBJ_TYPE_NUMBER, &result));
     if (err) goto end;
-    err = ESB(libsb_destroy_into(libj->libsb, &builder, &result->string.value, &result->string.size));
+    err = E(libj_string_duplicate(libj, libj->document, value, value_size, &result->number.text.value));
     if (err) goto end;
-    result->type = LIBJ_TYPE_NUMBER;
+    result->number.text.size = value_size;
     *json = result;
     result = NULL;
 end:
-    ESB(libsb_destroy(libj->libsb, &builder));
-    free(result);
+    if (libj) E(libj_free_json(libj, &result));
     return err;
 }
 
-LibjError libj_real_create(Libj *libj, LibjJson **json, double value) {
+LibjError libj_integer_create(Libj *libj, LibjJson **json, int64_t value) {
     LibjError err = LIBJ_ERROR_OK;
     LibjJson *result = NULL;
-    LibsbBuilder *builder = NULL;
     if (!libj || !json) {
         err = LIBJ_ERROR_BAD_ARGUMENT;
         goto end;
     }
-    result = malloc(sizeof(LibjJson));
-    if (!result) {
+    err = E(json_create(libj, libj->document, LIBJ_TYPE_NUMBER, &result));
+    if (err) goto end;
+    size_t size = libj_integer_size(value);
+    char *text = libj_allocate(libj->document, size + 1);
+    if (!text) {
         err = LIBJ_ERROR_OUT_OF_MEMORY;
         goto end;
     }
-    err = ESB(libsb_create(libj->libsb, &builder));
-    if (err) goto end;
-    err = ESB(libsb_append(libj->libsb, builder, "%lg", value));
+    libj_format_integer(value, text);
+    text[size] = '\0';
+    result->number.text.value = text;
+    result->number.text.size = size;
+    result->number.integer = value;
+    result->number.decoded = LIBJ_NUMBER_INTEGER_DECODED | LIBJ_NUMBER_INTEGER_EXACT;
+    err = E(number_decode(libj, &result->number, text, size));
     if (err) goto end;
-    err = ESB(libsb_destroy_into(libj->libsb, &builder, &result->string.value, &result->string.size));
-    if (err) goto end;
-    result->type = LIBJ_TYPE_NUMBER;
     *json = result;
     result = NULL;
 end:
-    ESB(libsb_destroy(libj->libsb, &builder));
-    free(result);
+    if (libj) E(libj_free_json(libj, &result));
+    return err;
+}
+
+LibjError libj_real_create(Libj *libj, LibjJson **json, double value) {
+    LibjError err = LIBJ_ERROR_OK;
+    char text[LIBJ_DOUBLE_BUFFER_SIZE];
+    if (!libj || !json || !isfinite(value)) {
+        err = LIBJ_ERROR_BAD_ARGUMENT;
+        goto end;
+    }
+    size_t text_size = libj_format_double(value, text);
+    err = E(number_create(libj, json, text, text_size));
+    if (err) goto end;
+    /* Text is the shortest one that converts back into value. */
+    (*json)->number.real = value;
+    (*json)->number.decoded = LIBJ_NUMBER_REAL_DECODED | LIBJ_NUMBER_REAL_EXACT;
+    err = E(number_decode(libj, &(*json)->number, text, text_size));
+    if (err) goto end;
+end:
     return err;
 }
 
 LibjError libj_number_create(Libj *libj, LibjJson **json, const char *value) {
     LibjError err = LIBJ_ERROR_OK;
-    LibjJson *result;
+    LibjJson *result = NULL;
     if (!libj || !json) {
         err = LIBJ_ERROR_BAD_ARGUMENT;
         goto end;
@@ -932,12 +1490,8 @@ LibjError libj_bool_create(Libj *libj, LibjJson **json, bool value) {
         err = LIBJ_ERROR_BAD_ARGUMENT;
         goto end;
     }
-    *json = malloc(sizeof(LibjJson));
-    if (!*json) {
-        err = LIBJ_ERROR_OUT_OF_MEMORY;
-        goto end;
-    }
-    (*json)->type = LIBJ_TYPE_BOOL;
+    err = E(json_create(libj, libj->document, LIBJ_TYPE_BOOL, json));
+    if (err) goto end;
     (*json)->boolean = value;
 end:
     return err;
@@ -949,12 +1503,8 @@ LibjError libj_null_create(Libj *libj, LibjJson **json) {
         err = LIBJ_ERROR_BAD_ARGUMENT;
         goto end;
     }
-    *json = malloc(sizeof(LibjJson));
-    if (!*json) {
-        err = LIBJ_ERROR_OUT_OF_MEMORY;
-        goto end;
-    }
-    (*json)->type = LIBJ_TYPE_NULL;
+    err = E(json_create(libj, libj->document, LIBJ_TYPE_NULL, json));
+    if (err) goto end;
 end:
     return err;
 }
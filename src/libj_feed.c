@@ -0,0 +1,418 @@
+#include "libj_internal.h"
+#include "libj_utils.h"
+#include "libj_simd.h"
+
+#include <stdio.h>
+#include <string.h>
+
+/* What the push parser expects to find next. */
+typedef enum {
+    FEED_START,         /* byte order mark or the value */
+    FEED_VALUE,         /* a value */
+    FEED_FIRST_KEY,     /* first member name or end of object */
+    FEED_FIRST_ELEMENT, /* first element or end of array */
+    FEED_KEY,           /* member name after a comma */
+    FEED_COLON,         /* colon after member name */
+    FEED_NEXT,          /* comma or end of the innermost container */
+    FEED_STRING,        /* rest of a string or member name */
+    FEED_SCALAR,        /* rest of a number, true, false or null */
+    FEED_DONE,          /* nothing, the value is over */
+} FeedState;
+
+/* Brackets, commas and colons are handled here while strings and scalars are gathered until they are complete and
+ * then passed to the usual grammar, which reports them to the builder. */
+struct LibjPushParser_ {
+    LibjParser parser;
+    LibjBuilder builder;
+    LibjScratch token; /* beginning of the string or scalar that previous chunks have ended in */
+    FeedState state;
+    LibjError failed;
+    char *error_string; /* copy of the message of the failure, NULL if there was none */
+    size_t bom; /* bytes of byte order mark seen so far */
+    bool key; /* whether the string being read is a member name */
+    bool escaped; /* whether the string being read has ended in a backslash that escapes the next byte */
+    size_t depth;
+    bool objects[LIBJ_MAX_DEPTH]; /* whether each open container is an object, innermost last */
+};
+
+LibjError libj_push_parser_create(Libj *libj, LibjPushParser **parser) {
+    LibjError err = LIBJ_ERROR_OK;
+    LibjPushParser *result = NULL;
+    if (!libj || !parser) {
+        err = LIBJ_ERROR_BAD_ARGUMENT;
+        goto end;
+    }
+    result = malloc(sizeof(LibjPushParser));
+    if (!result) {
+        err = LIBJ_ERROR_OUT_OF_MEMORY;
+        goto end;
+    }
+    parser_init(&result->parser, libj, NULL, &builder_handler, &result->builder);
+    builder_init(&result->builder, libj, &result->parser);
+    result->token.bytes = NULL;
+    result->token.size = 0;
+    result->token.capacity = 0;
+    result->state = FEED_START;
+    result->failed = LIBJ_ERROR_OK;
+    result->error_string = NULL;
+    result->bom = 0;
+    result->key = false;
+    result->escaped = false;
+    result->depth = 0;
+    *parser = result;
+    result = NULL;
+end:
+    free(result);
+    return err;
+}
+
+LibjError libj_push_parser_free(Libj *libj, LibjPushParser **parser) {
+    LibjError err = LIBJ_ERROR_OK;
+    if (!libj || !parser) {
+        err = LIBJ_ERROR_BAD_ARGUMENT;
+        goto end;
+    }
+    if (*parser) {
+        builder_free(&(*parser)->builder);
+        free((*parser)->parser.scratch.bytes);
+        free((*parser)->token.bytes);
+        free((*parser)->error_string);
+    }
+    free(*parser);
+    *parser = NULL;
+end:
+    return err;
+}
+
+/* Bytes that numbers, true, false and null are made of. Anything else ends them. */
+static bool is_scalar_byte(char c) {
+    return ('0' <= c && c <= '9') || ('a' <= c && c <= 'z') || ('A' <= c && c <= 'Z')
+            || '-' == c || '+' == c || '.' == c;
+}
+
+/* State after a value has been read. */
+static FeedState after_value(LibjPushParser *parser) {
+    return parser->depth ? FEED_NEXT : FEED_DONE;
+}
+
+/* Parse string or scalar that is all of text and report it to the builder. */
+static LibjError parse_token(LibjPushParser *parser, const char *text, size_t text_size) {
+    LibjError err = LIBJ_ERROR_OK;
+    LibjInput input;
+    if (!parser || !text) {
+        err = LIBJ_ERROR_BAD_ARGUMENT;
+        goto end;
+    }
+    Libj *libj = parser->parser.libj;
+    libj_input_from_buffer(&input, text, text_size);
+    parser->parser.input = &input;
+    err = parser->key ? E(libj_parse_key(&parser->parser)) : E(libj_parse_value(&parser->parser));
+    parser->parser.input = NULL;
+    /* Callbacks of the builder stop parsing only because of their own errors. */
+    if (LIBJ_ERROR_STOPPED == err) {
+        err = parser->builder.err;
+    }
+    if (err) goto end;
+    /* Scalars run up to the next byte that can't be part of any of them, like "1true" does. */
+    if (input.current != input.end && parser->depth) {
+        bool object = parser->objects[parser->depth - 1];
+        E(errorf(libj, object ? "} or , was expected" : "] or , was expected", 0));
+        err = LIBJ_ERROR_SYNTAX;
+        goto end;
+    }
+    parser->token.size = 0;
+    parser->state = parser->key ? FEED_COLON : after_value(parser);
+end:
+    return err;
+}
+
+/* Parse token whose part in the current chunk is [begin, end). */
+static LibjError finish_token(LibjPushParser *parser, const char *begin, const char *end) {
+    LibjError err = LIBJ_ERROR_OK;
+    if (!parser || !begin || !end) {
+        err = LIBJ_ERROR_BAD_ARGUMENT;
+        goto end;
+    }
+    /* Tokens that are whole within one chunk are parsed right where they are. */
+    if (!parser->token.size) {
+        err = E(parse_token(parser, begin, end - begin));
+        goto end;
+    }
+    err = E(scratch_append(&parser->token, begin, end - begin));
+    if (err) goto end;
+    err = E(parse_token(parser, parser->token.bytes, parser->token.size));
+    if (err) goto end;
+end:
+    return err;
+}
+
+/* Move *c past the bytes of the string being read up to and including its closing quote. Returns whether the
+ * quote was found before end. Escape sequences and characters are checked later by the grammar. */
+static bool scan_string(LibjPushParser *parser, const char **c, const char *end) {
+    const char *current = *c;
+    bool closed = false;
+    while (current != end) {
+        if (parser->escaped) {
+            parser->escaped = false;
+            ++current;
+            continue;
+        }
+        current += libj_simd_scan_string(current, end);
+        if (current == end) {
+            break;
+        }
+        char byte = *current++;
+        if ('"' == byte) {
+            closed = true;
+            break;
+        }
+        parser->escaped = '\\' == byte;
+    }
+    *c = current;
+    return closed;
+}
+
+static LibjError open_container(LibjPushParser *parser, bool object) {
+    LibjError err = LIBJ_ERROR_OK;
+    if (!parser) {
+        err = LIBJ_ERROR_BAD_ARGUMENT;
+        goto end;
+    }
+    const LibjHandler *handler = parser->parser.handler;
+    if (LIBJ_MAX_DEPTH == parser->depth) {
+        E(errorf(parser->parser.libj, "too many nesting levels", 0));
+        err = LIBJ_ERROR_SYNTAX;
+        goto end;
+    }
+    if (!(object ? handler->on_object_start : handler->on_array_start)(parser->parser.user)) {
+        err = parser->builder.err;
+        goto end;
+    }
+    parser->objects[parser->depth++] = object;
+    parser->state = object ? FEED_FIRST_KEY : FEED_FIRST_ELEMENT;
+end:
+    return err;
+}
+
+static LibjError close_container(LibjPushParser *parser) {
+    LibjError err = LIBJ_ERROR_OK;
+    if (!parser || !parser->depth) {
+        err = LIBJ_ERROR_BAD_ARGUMENT;
+        goto end;
+    }
+    const LibjHandler *handler = parser->parser.handler;
+    bool object = parser->objects[--parser->depth];
+    if (!(object ? handler->on_object_end : handler->on_array_end)(parser->parser.user)) {
+        err = parser->builder.err;
+        goto end;
+    }
+    parser->state = after_value(parser);
+end:
+    return err;
+}
+
+/* Start string or member name at the quote c points to. */
+static void start_string(LibjPushParser *parser, const char **token, const char **c, bool key) {
+    *token = (*c)++;
+    parser->key = key;
+    parser->escaped = false;
+    parser->state = FEED_STRING;
+}
+
+/* Parse bytes of chunk until it ends or the value is over. */
+static LibjError feed(LibjPushParser *parser, const char *chunk, size_t chunk_size) {
+    LibjError err = LIBJ_ERROR_OK;
+    static const char *bom = "\xEF\xBB\xBF";
+    if (!parser || !chunk) {
+        err = LIBJ_ERROR_BAD_ARGUMENT;
+        goto end;
+    }
+    Libj *libj = parser->parser.libj;
+    const char *c = chunk;
+    const char *end = chunk + chunk_size;
+    const char *token = chunk; /* where the part of the current token in this chunk begins */
+    while (c != end && FEED_DONE != parser->state) {
+        switch (parser->state) {
+        case FEED_START:
+            if (!parser->bom && bom[0] != *c) {
+                parser->state = FEED_VALUE;
+                break;
+            }
+            if (bom[parser->bom] != *c) {
+                E(errorf(libj, "unexpected byte '%c'(0x%02X)", *c, (unsigned char) *c));
+                err = LIBJ_ERROR_SYNTAX;
+                goto end;
+            }
+            ++c;
+            if (3 == ++parser->bom) {
+                parser->state = FEED_VALUE;
+            }
+            break;
+        case FEED_STRING:
+            if (scan_string(parser, &c, end)) {
+                err = E(finish_token(parser, token, c));
+                if (err) goto end;
+            }
+            break;
+        case FEED_SCALAR:
+            while (c != end && is_scalar_byte(*c)) {
+                ++c;
+            }
+            if (c != end) {
+                err = E(finish_token(parser, token, c));
+                if (err) goto end;
+            }
+            break;
+        default:
+            c += libj_simd_skip_whitespace(c, end);
+            if (c == end) {
+                break;
+            }
+            switch (parser->state) {
+            case FEED_VALUE:
+                if ('{' == *c || '[' == *c) {
+                    bool object = '{' == *c++;
+                    err = E(open_container(parser, object));
+                    if (err) goto end;
+                } else if ('"' == *c) {
+                    start_string(parser, &token, &c, false);
+                } else if (is_scalar_byte(*c)) {
+                    token = c;
+                    parser->key = false;
+                    parser->state = FEED_SCALAR;
+                } else {
+                    E(errorf(libj, "json value was expected", 0));
+                    err = LIBJ_ERROR_SYNTAX;
+                    goto end;
+                }
+                break;
+            case FEED_FIRST_KEY:
+                if ('}' == *c) {
+                    ++c;
+                    err = E(close_container(parser));
+                    if (err) goto end;
+                    break;
+                }
+                parser->state = FEED_KEY;
+                break;
+            case FEED_FIRST_ELEMENT:
+                if (']' == *c) {
+                    ++c;
+                    err = E(close_container(parser));
+                    if (err) goto end;
+                    break;
+                }
+                parser->state = FEED_VALUE;
+                break;
+            case FEED_KEY:
+                if ('"' != *c) {
+                    E(errorf(libj, "'%s' was expected", "\""));
+                    err = LIBJ_ERROR_SYNTAX;
+                    goto end;
+                }
+                start_string(parser, &token, &c, true);
+                break;
+            case FEED_COLON:
+                if (':' != *c) {
+                    E(errorf(libj, "'%s' was expected", ":"));
+                    err = LIBJ_ERROR_SYNTAX;
+                    goto end;
+                }
+                ++c;
+                parser->state = FEED_VALUE;
+                break;
+            case FEED_NEXT: {
+                bool object = parser->objects[parser->depth - 1];
+                if ((object ? '}' : ']') == *c) {
+                    ++c;
+                    err = E(close_container(parser));
+                    if (err) goto end;
+                    break;
+                }
+                if (',' != *c) {
+                    E(errorf(libj, object ? "} or , was expected" : "] or , was expected", 0));
+                    err = LIBJ_ERROR_SYNTAX;
+                    goto end;
+                }
+                ++c;
+                parser->state = object ? FEED_KEY : FEED_VALUE;
+                break;
+            }
+            default:
+                err = LIBJ_ERROR_BAD_ARGUMENT;
+                goto end;
+            }
+            break;
+        }
+    }
+    /* Token that goes on in the next chunk is kept until it's complete. */
+    if (FEED_STRING == parser->state || FEED_SCALAR == parser->state) {
+        err = E(scratch_append(&parser->token, token, end - token));
+        if (err) goto end;
+    }
+end:
+    return err;
+}
+
+/* Input is over, so a scalar at the top level is complete and anything else unfinished is an error. */
+static LibjError feed_end(LibjPushParser *parser) {
+    LibjError err = LIBJ_ERROR_OK;
+    if (!parser) {
+        err = LIBJ_ERROR_BAD_ARGUMENT;
+        goto end;
+    }
+    if (FEED_SCALAR == parser->state && !parser->depth) {
+        err = E(parse_token(parser, parser->token.bytes, parser->token.size));
+        if (err) goto end;
+    }
+    if (FEED_DONE != parser->state) {
+        E(errorf(parser->parser.libj, "unexpected end of file", 0));
+        err = LIBJ_ERROR_SYNTAX;
+        goto end;
+    }
+end:
+    return err;
+}
+
+/* Message of the failure of parser. */
+static const char *parser_error_string(LibjPushParser *parser) {
+    return parser->error_string ? parser->error_string : libj_error_to_human_readable_string(parser->failed);
+}
+
+LibjError libj_feed(Libj *libj, LibjPushParser *parser, const char *chunk, size_t chunk_size,
+                    LibjFeedStatus *status, LibjJson **json, const char **error_string) {
+    LibjError err = LIBJ_ERROR_OK;
+    if (!libj || !parser || (!chunk && chunk_size) || !status || !json || !error_string) {
+        err = LIBJ_ERROR_BAD_ARGUMENT;
+        goto end;
+    }
+    *status = LIBJ_FEED_NEED_MORE;
+    *json = NULL;
+    if (parser->failed) {
+        err = parser->failed;
+        *error_string = parser_error_string(parser);
+        goto end;
+    }
+    free(libj->error_string);
+    libj->error_string = NULL;
+    if (FEED_DONE != parser->state) {
+        err = chunk_size ? E(feed(parser, chunk, chunk_size)) : E(feed_end(parser));
+    }
+    if (err) {
+        /* Message of libj is replaced by the next call with it, so the parser keeps a copy. */
+        parser->failed = err;
+        if (libj->error_string) {
+            parser->error_string = strdup(libj->error_string);
+        }
+        *error_string = parser_error_string(parser);
+        goto end;
+    }
+    *error_string = "";
+    if (FEED_DONE == parser->state) {
+        *status = LIBJ_FEED_DONE;
+        *json = parser->builder.root;
+        parser->builder.root = NULL;
+    }
+end:
+    return err;
+}
@@ -1,15 +1,14 @@
 #include "libj_internal.h"
 #include "libj_utils.h"
+#include "libj_simd.h"
+#include "libj_atod.h"
 #include <libutf.h>
 
 #include <string.h>
 #include <assert.h>
-#include <locale.h>
 #include <stdio.h>
 
-#define LIBJ_MAX_DEPTH 100
-
-static LibjError errorf(Libj *libj, const char *format, ...) {
+LibjError errorf(Libj *libj, const char *format, ...) {
     va_list args;
     va_start(args, format);
     LibsbBuilder *builder = NULL;
@@ -31,7 +30,7 @@ end:
     return err;
 }
 
-static LibjError libj_skip_literal(Libj *libj, LibisInputStream *input, const char *literal) {
+LibjError libj_skip_literal(Libj *libj, LibjInput *input, const char *literal) {
     LibjError err = LIBJ_ERROR_OK;
     char c;
     bool eof;
@@ -47,185 +46,61 @@ static LibjError libj_skip_literal(Libj *libj, LibisInputStream *input, const ch
             E(errorf(libj, "'%s' was expected", literal));
             goto end;
         }
-        err = EIS(libis_skip_char(libj->libis, input, &eof, &c));
-        if (err) goto end;
-    }
-end:
-    return err;
-}
-
-LibjError libj_parse_value_object(Libj *libj, LibjJson **json, LibisInputStream *input) {
-    LibjError err = LIBJ_ERROR_OK;
-    LibjJson *result = NULL;
-    LibjJson *name = NULL;
-    LibjJson *value = NULL;
-    char c;
-    bool eof;
-    if (!libj || !json || !input) {
-        err = LIBJ_ERROR_BAD_ARGUMENT;
-        goto end;
-    }
-    err = E(libj_object_create(libj, &result));
-    if (err) goto end;
-    err = E(libj_skip_literal(libj, input, "{"));
-    if (err) goto end;
-    err = libj_skip_whitespace(libj, input, &eof, &c);
-    if (err) goto end;
-    if ('}' == c) {
-        err = E(libj_skip_literal(libj, input, "}"));
-        if (err) goto end;
-        *json = result;
-        result = NULL;
-        goto end;
-    }
-    if (libj->depth == LIBJ_MAX_DEPTH) {
-        err = LIBJ_ERROR_SYNTAX;
-        E(errorf(libj, "too many nesting levels", 0));
-        goto end;
-    }
-    ++libj->depth;
-    for (;;) {
-        err = E(libj_parse_value_string(libj, &name, input));
-        assert((bool) err != (bool) name);
-        if (err) goto end;
-        err = E(libj_skip_literal(libj, input, ":"));
-        if (err) goto end;
-        err = E(libj_parse_value(libj, &value, input));
-        if (err) goto end;
-        err = E(libj_object_add_ex(libj, result, name->string.value, name->string.size, value));
-        if (err) goto end;
-        err = E(libj_free_json(libj, &name));
-        if (err) goto end;
-        err = E(libj_free_json(libj, &value));
-        if (err) goto end;
-        err = libj_skip_whitespace(libj, input, &eof, &c);
-        if (err) goto end;
-        if ('}' != c && ',' != c) {
-            E(errorf(libj, "} or , was expected", 0));
-            err = LIBJ_ERROR_SYNTAX;
-            goto end;
-        }
-        if ('}' == c) {
-            err = E(libj_skip_literal(libj, input, "}"));
-            if (err) goto end;
-            break;
-        }
-        err = EIS(libis_skip_char(libj->libis, input, &eof, &c));
+        err = libj_input_skip_char(libj, input, &eof, &c);
         if (err) goto end;
     }
-    --libj->depth;
-    *json = result;
-    result = NULL;
 end:
-    E(libj_free_json(libj, &result));
-    E(libj_free_json(libj, &name));
-    E(libj_free_json(libj, &value));
     return err;
 }
 
-LibjError libj_parse_value_array(Libj *libj, LibjJson **json, LibisInputStream *input) {
+/* Make room for size more bytes in scratch. */
+static LibjError scratch_reserve(LibjScratch *scratch, size_t size) {
     LibjError err = LIBJ_ERROR_OK;
-    LibjJson *result = NULL;
-    LibjJson *element = NULL;
-    char c;
-    bool eof;
-    if (!libj || !json || !input) {
+    if (!scratch) {
         err = LIBJ_ERROR_BAD_ARGUMENT;
         goto end;
     }
-    err = E(libj_array_create(libj, &result));
-    if (err) goto end;
-    err = E(libj_skip_literal(libj, input, "["));
-    if (err) goto end;
-    err = libj_skip_whitespace(libj, input, &eof, &c);
-    if (err) goto end;
-    if (']' == c) {
-        err = E(libj_skip_literal(libj, input, "]"));
-        if (err) goto end;
-        *json = result;
-        result = NULL;
+    if (size <= scratch->capacity - scratch->size) {
         goto end;
     }
-    if (libj->depth == LIBJ_MAX_DEPTH) {
-        err = LIBJ_ERROR_SYNTAX;
-        E(errorf(libj, "too many nesting levels", 0));
+    if (SIZE_MAX - scratch->size < size) {
+        err = LIBJ_ERROR_OUT_OF_MEMORY;
         goto end;
     }
-    ++libj->depth;
-    for (;;) {
-        err = E(libj_parse_value(libj, &element, input));
-        if (err) goto end;
-        err = E(libj_array_add(libj, result, element));
-        if (err) goto end;
-        err = E(libj_free_json(libj, &element));
-        if (err) goto end;
-        err = libj_skip_whitespace(libj, input, &eof, &c);
-        if (err) goto end;
-        if (']' != c && ',' != c) {
-            E(errorf(libj, "] or , was expected", 0));
-            err = LIBJ_ERROR_SYNTAX;
-            goto end;
-        }
-        if (']' == c) {
-            err = E(libj_skip_literal(libj, input, "]"));
-            if (err) goto end;
+    size_t capacity = scratch->capacity ? scratch->capacity : 64;
+    while (capacity < scratch->size + size) {
+        if (SIZE_MAX / 2 < capacity) {
+            capacity = scratch->size + size;
             break;
         }
-        err = EIS(libis_skip_char(libj->libis, input, &eof, &c));
-        if (err) goto end;
+        capacity *= 2;
     }
-    --libj->depth;
-    *json = result;
-    result = NULL;
-end:
-    E(libj_free_json(libj, &result));
-    E(libj_free_json(libj, &element));
-    return err;
-}
-
-LibjError libj_parse_value_true(Libj *libj, LibjJson **json, LibisInputStream *input) {
-    LibjError err = LIBJ_ERROR_OK;
-    if (!libj || !json || !input) {
-        err = LIBJ_ERROR_BAD_ARGUMENT;
-        goto end;
-    }
-    err = E(libj_skip_literal(libj, input, "true"));
-    if (err) goto end;
-    err = E(libj_bool_create(libj, json, true));
-    if (err) goto end;
-end:
-    return err;
-}
-
-LibjError libj_parse_value_false(Libj *libj, LibjJson **json, LibisInputStream *input) {
-    LibjError err = LIBJ_ERROR_OK;
-    if (!libj || !json || !input) {
-        err = LIBJ_ERROR_BAD_ARGUMENT;
+    char *bytes = realloc(scratch->bytes, capacity);
+    if (!bytes) {
+        err = LIBJ_ERROR_OUT_OF_MEMORY;
         goto end;
     }
-    err = E(libj_skip_literal(libj, input, "false"));
-    if (err) goto end;
-    err = E(libj_bool_create(libj, json, false));
-    if (err) goto end;
+    scratch->bytes = bytes;
+    scratch->capacity = capacity;
 end:
     return err;
 }
 
-LibjError libj_parse_value_null(Libj *libj, LibjJson **json, LibisInputStream *input) {
+LibjError scratch_append(LibjScratch *scratch, const char *bytes, size_t size) {
     LibjError err = LIBJ_ERROR_OK;
-    if (!libj || !json || !input) {
+    if (!scratch || !bytes) {
         err = LIBJ_ERROR_BAD_ARGUMENT;
         goto end;
     }
-    err = E(libj_skip_literal(libj, input, "null"));
-    if (err) goto end;
-    err = E(libj_null_create(libj, json));
+    err = E(scratch_reserve(scratch, size));
     if (err) goto end;
+    memcpy(scratch->bytes + scratch->size, bytes, size);
+    scratch->size += size;
 end:
     return err;
 }
 
-static LibjError consume_utf8_character(Libj *libj, LibisInputStream *input, LibgbBuffer *buffer) {
+static LibjError consume_utf8_character(Libj *libj, LibjInput *input, LibjScratch *buffer) {
     LibjError err = LIBJ_ERROR_OK;
     char c;
     bool eof;
@@ -233,7 +108,7 @@ static LibjError consume_utf8_character(Libj *libj, LibisInputStream *input, Lib
         err = LIBJ_ERROR_BAD_ARGUMENT;
         goto end;
     }
-    err = EIS(libis_lookahead(libj->libis, input, &eof, 1, &c));
+    err = libj_input_lookahead(libj, input, &eof, &c);
     if (err) goto end;
     LibutfC8Type type = libutf_c8_type(c);
     if (type < 0) {
@@ -247,9 +122,9 @@ static LibjError consume_utf8_character(Libj *libj, LibisInputStream *input, Lib
     int i;
     for (i = 0; i < length && c != EOF; ++i) {
         temp[i] = (char) c;
-        err = EGB(libgb_append_buffer(libj->libgb, buffer, &temp[i], 1));
+        err = E(scratch_append(buffer, &temp[i], 1));
         if (err) goto end;
-        err = EIS(libis_skip_char(libj->libis, input, &eof, &c));
+        err = libj_input_skip_char(libj, input, &eof, &c);
         if (err) goto end;
     }
     if (i != length) {
@@ -268,7 +143,57 @@ end:
     return err;
 }
 
-static LibjError consume_hex(Libj *libj, LibisInputStream *input, int *value) {
+/* Whether [begin, end) is valid UTF-8. ASCII is checked a word at a time, everything else is decoded the same
+ * way consume_utf8_character() does it. */
+static bool is_utf8(const char *begin, const char *end) {
+    const char *p = begin;
+    while (p != end) {
+        uint64_t word;
+        if (8 <= end - p && (memcpy(&word, p, 8), !(word & UINT64_C(0x8080808080808080)))) {
+            p += 8;
+            continue;
+        }
+        LibutfC8Type type = libutf_c8_type(*p);
+        if (type < 0) {
+            return false;
+        }
+        int length = type;
+        if (end - p < length) {
+            return false;
+        }
+        char temp[5];
+        memcpy(temp, p, length);
+        temp[length] = '\0';
+        uint32_t c32;
+        if (!libutf_c8_to_c32(temp, &c32)) {
+            return false;
+        }
+        p += length;
+    }
+    return true;
+}
+
+/* Consume everything up to the next quote, backslash or control character of buffer input at once. */
+static LibjError consume_utf8_run(Libj *libj, LibjInput *input, LibjScratch *buffer) {
+    LibjError err = LIBJ_ERROR_OK;
+    if (!libj || !input || input->stream || !buffer) {
+        err = LIBJ_ERROR_BAD_ARGUMENT;
+        goto end;
+    }
+    size_t size = libj_simd_scan_string(input->current, input->end);
+    if (!is_utf8(input->current, input->current + size)) {
+        err = LIBJ_ERROR_SYNTAX;
+        E(errorf(libj, "input is not UTF-8", 0));
+        goto end;
+    }
+    err = E(scratch_append(buffer, input->current, size));
+    if (err) goto end;
+    input->current += size;
+end:
+    return err;
+}
+
+static LibjError consume_hex(Libj *libj, LibjInput *input, int *value) {
     LibjError err = LIBJ_ERROR_OK;
     char c;
     bool eof;
@@ -277,7 +202,7 @@ static LibjError consume_hex(Libj *libj, LibisInputStream *input, int *value) {
         goto end;
     }
     *value = 0;
-    err = EIS(libis_lookahead(libj->libis, input, &eof, 1, &c));
+    err = libj_input_lookahead(libj, input, &eof, &c);
     if (err) goto end;
     if ('0' <= c && c <= '9') {
         *value = c - '0';
@@ -291,13 +216,13 @@ static LibjError consume_hex(Libj *libj, LibisInputStream *input, int *value) {
         E(errorf(libj, "hexadecimal was expected", 0));
         goto end;
     }
-    err = EIS(libis_skip_char(libj->libis, input, &eof, &c));
+    err = libj_input_skip_char(libj, input, &eof, &c);
     if (err) goto end;
 end:
     return err;
 }
 
-static LibjError consume_hex4(Libj *libj, LibisInputStream *input, uint32_t *u32) {
+static LibjError consume_hex4(Libj *libj, LibjInput *input, uint32_t *u32) {
     LibjError err = LIBJ_ERROR_OK;
     if (!libj || !input || !u32) {
         err = LIBJ_ERROR_BAD_ARGUMENT;
@@ -336,15 +261,17 @@ static char escape(char c) {
     abort();
 }
 
-LibjError libj_consume_escape_sequence(Libj *libj, LibisInputStream *input, LibgbBuffer *buffer) {
+/* Decode escape sequence that starts at the backslash input is at into at most 4 bytes of UTF-8. Escape sequence
+ * is never shorter than what it decodes into. */
+static LibjError decode_escape_sequence(Libj *libj, LibjInput *input, char bytes[4], int *size) {
     LibjError err = LIBJ_ERROR_OK;
     char c;
     bool eof;
-    if (!libj || !input || !buffer) {
+    if (!libj || !input || !bytes || !size) {
         err = LIBJ_ERROR_BAD_ARGUMENT;
         goto end;
     }
-    err = EIS(libis_skip_char(libj->libis, input, &eof, &c));
+    err = libj_input_skip_char(libj, input, &eof, &c);
     if (err) goto end;
     switch (c) {
     case '\\':
@@ -355,14 +282,13 @@ LibjError libj_consume_escape_sequence(Libj *libj, LibisInputStream *input, Libg
     case 'n':
     case 'r':
     case 't':
-        c = escape(c);
-        err = EGB(libgb_append_buffer(libj->libgb, buffer, &c, 1));
-        if (err) goto end;
-        err = EIS(libis_skip_char(libj->libis, input, &eof, &c));
+        bytes[0] = escape(c);
+        *size = 1;
+        err = libj_input_skip_char(libj, input, &eof, &c);
         if (err) goto end;
         break;
     case 'u': {
-        err = EIS(libis_skip_char(libj->libis, input, &eof, &c));
+        err = libj_input_skip_char(libj, input, &eof, &c);
         if (err) goto end;
         uint32_t p = 0;
         err = E(consume_hex4(libj, input, &p));
@@ -392,15 +318,11 @@ LibjError libj_consume_escape_sequence(Libj *libj, LibisInputStream *input, Libg
                 goto end;
             }
         }
-        char c8_bytes[5];
-        int c8_size;
-        if (!libutf_c32_to_c8(p, &c8_size, c8_bytes)) {
+        if (!libutf_c32_to_c8(p, size, bytes)) {
             err = LIBJ_ERROR_SYNTAX;
             E(errorf(libj, "input is not UTF-8", 0));
             goto end;
         }
-        err = EGB(libgb_append_buffer(libj->libgb, buffer, c8_bytes, c8_size));
-        if (err) goto end;
         break;
     }
     default:
@@ -412,25 +334,68 @@ end:
     return err;
 }
 
-LibjError libj_parse_value_string(Libj *libj, LibjJson **json, LibisInputStream *input) {
+LibjError libj_consume_escape_sequence(Libj *libj, LibjInput *input, LibjScratch *buffer) {
+    LibjError err = LIBJ_ERROR_OK;
+    char bytes[4];
+    int size = 0;
+    if (!libj || !input || !buffer) {
+        err = LIBJ_ERROR_BAD_ARGUMENT;
+        goto end;
+    }
+    err = E(decode_escape_sequence(libj, input, bytes, &size));
+    if (err) goto end;
+    err = E(scratch_append(buffer, bytes, size));
+    if (err) goto end;
+end:
+    return err;
+}
+
+/* Take string of buffer input right from the buffer if it has no escape sequences. Otherwise *value is set to
+ * NULL and input is left untouched. */
+static LibjError parse_string_in_place(LibjParser *parser, const char **value, size_t *value_size) {
+    LibjError err = LIBJ_ERROR_OK;
+    if (!parser || !value || !value_size || parser->input->stream) {
+        err = LIBJ_ERROR_BAD_ARGUMENT;
+        goto end;
+    }
+    LibjInput *input = parser->input;
+    *value = NULL;
+    if (input->current == input->end || '"' != *input->current) {
+        goto end;
+    }
+    const char *begin = input->current + 1;
+    const char *end = begin + libj_simd_scan_string(begin, input->end);
+    if (end == input->end || '"' != *end || !is_utf8(begin, end)) {
+        goto end;
+    }
+    input->current = end + 1;
+    *value = begin;
+    *value_size = end - begin;
+    parser->in_input = true;
+end:
+    return err;
+}
+
+/* Parse string of buffer input and unescape it in place. Unescaped string is never longer than its escaped form so
+ * it's written over the bytes that have already been read and terminated where its closing quote was. */
+static LibjError parse_string_insitu(LibjParser *parser, const char **value, size_t *value_size) {
     LibjError err = LIBJ_ERROR_OK;
-    LibgbBuffer *buffer = NULL;
-    char *string_value = NULL;
-    size_t string_size = 0;
-    char null = '\0';
     char c;
     bool eof;
-    if (!libj || !json || !input) {
+    if (!parser || !value || !value_size || parser->input->stream
+            || LIBJ_STRING_INSITU != parser->input->strings) {
         err = LIBJ_ERROR_BAD_ARGUMENT;
         goto end;
     }
-    *json = NULL;
+    Libj *libj = parser->libj;
+    LibjInput *input = parser->input;
     err = E(libj_skip_literal(libj, input, "\""));
     if (err) goto end;
-    err = EGB(libgb_create(libj->libgb, &buffer));
-    if (err) goto end;
+    /* Buffer of in-situ input is passed mutable by the caller. */
+    char *begin = (char *) input->current;
+    char *value_end = begin;
     for (;;) {
-        err = EIS(libis_lookahead(libj->libis, input, &eof, 1, &c));
+        err = libj_input_lookahead(libj, input, &eof, &c);
         if (err) goto end;
         if (EOF == c) {
             err = LIBJ_ERROR_SYNTAX;
@@ -441,256 +406,629 @@ LibjError libj_parse_value_string(Libj *libj, LibjJson **json, LibisInputStream
         case '\"':
             err = E(libj_skip_literal(libj, input, "\""));
             if (err) goto end;
-            err = EGB(libgb_append_buffer(libj->libgb, buffer, &null, 1));
-            if (err) goto end;
-            err = EGB(libgb_destroy_into(libj->libgb, &buffer, &string_value, &string_size));
-            if (err) goto end;
-            --string_size;
-            err = E(libj_string_create_ex(libj, json, string_value, string_size));
-            if (err) goto end;
+            *value_end = '\0';
+            *value = begin;
+            *value_size = value_end - begin;
+            parser->in_input = true;
             goto end;
         case '\x00':
             E(errorf(libj, "null character is not escaped", 0));
             err = LIBJ_ERROR_SYNTAX;
             goto end;
-        case '\\':
-            err = E(libj_consume_escape_sequence(libj, input, buffer));
+        case '\\': {
+            char bytes[4];
+            int size = 0;
+            err = E(decode_escape_sequence(libj, input, bytes, &size));
             if (err) goto end;
+            memcpy(value_end, bytes, size);
+            value_end += size;
             break;
-        default:
+        }
+        default: {
             if ((unsigned char) c < 0x20) {
                 E(errorf(libj, "control character is not escaped", 0));
                 err = LIBJ_ERROR_SYNTAX;
                 goto end;
             }
-            err = E(consume_utf8_character(libj, input, buffer));
-            if (err) goto end;
+            size_t size = libj_simd_scan_string(input->current, input->end);
+            if (!is_utf8(input->current, input->current + size)) {
+                err = LIBJ_ERROR_SYNTAX;
+                E(errorf(libj, "input is not UTF-8", 0));
+                goto end;
+            }
+            memmove(value_end, input->current, size);
+            value_end += size;
+            input->current += size;
             break;
         }
+        }
     }
 end:
-    free(string_value);
-    if (libj) EGB(libgb_destroy(libj->libgb, &buffer));
     return err;
 }
 
-static LibjError consume_sign(Libj *libj, LibisInputStream *input, LibgbBuffer *buffer) {
+/* Parse string and unescape it. *value points either into buffer input or into scratch of parser, in the latter
+ * case it's null-terminated. */
+static LibjError parse_string(LibjParser *parser, const char **value, size_t *value_size) {
     LibjError err = LIBJ_ERROR_OK;
+    char null = '\0';
     char c;
     bool eof;
-    if (!libj || !input || !buffer) {
+    if (!parser || !value || !value_size) {
         err = LIBJ_ERROR_BAD_ARGUMENT;
         goto end;
     }
-    err = EIS(libis_lookahead(libj->libis, input, &eof, 1, &c));
+    Libj *libj = parser->libj;
+    LibjInput *input = parser->input;
+    if (LIBJ_STRING_INSITU == input->strings) {
+        err = E(parse_string_insitu(parser, value, value_size));
+        goto end;
+    }
+    if (!input->stream) {
+        err = E(parse_string_in_place(parser, value, value_size));
+        if (err || *value) goto end;
+    }
+    err = E(libj_skip_literal(libj, input, "\""));
     if (err) goto end;
-    if ('+' == c || '-' == c) {
-        char t = c;
-        err = EGB(libgb_append_buffer(libj->libgb, buffer, &t, 1));
-        if (err) goto end;
-        err = EIS(libis_skip_char(libj->libis, input, &eof, &c));
+    LibjScratch *buffer = &parser->scratch;
+    buffer->size = 0;
+    for (;;) {
+        err = libj_input_lookahead(libj, input, &eof, &c);
         if (err) goto end;
+        if (EOF == c) {
+            err = LIBJ_ERROR_SYNTAX;
+            E(errorf(libj, "unexpected end of file", 0));
+            goto end;
+        }
+        switch (c) {
+        case '\"':
+            err = E(libj_skip_literal(libj, input, "\""));
+            if (err) goto end;
+            err = E(scratch_append(buffer, &null, 1));
+            if (err) goto end;
+            *value = buffer->bytes;
+            *value_size = buffer->size - 1;
+            parser->in_input = false;
+            goto end;
+        case '\x00':
+            E(errorf(libj, "null character is not escaped", 0));
+            err = LIBJ_ERROR_SYNTAX;
+            goto end;
+        case '\\':
+            err = E(libj_consume_escape_sequence(libj, input, buffer));
+            if (err) goto end;
+            break;
+        default:
+            if ((unsigned char) c < 0x20) {
+                E(errorf(libj, "control character is not escaped", 0));
+                err = LIBJ_ERROR_SYNTAX;
+                goto end;
+            }
+            if (input->stream) {
+                err = E(consume_utf8_character(libj, input, buffer));
+            } else {
+                err = E(consume_utf8_run(libj, input, buffer));
+            }
+            if (err) goto end;
+            break;
+        }
     }
 end:
     return err;
 }
 
-static LibjError consume_digit(Libj *libj, LibisInputStream *input, LibgbBuffer *buffer) {
+LibjError libj_parse_value_string(LibjParser *parser) {
     LibjError err = LIBJ_ERROR_OK;
-    char c;
-    bool eof;
-    if (!libj || !input || !buffer) {
+    const char *value;
+    size_t value_size;
+    if (!parser) {
         err = LIBJ_ERROR_BAD_ARGUMENT;
         goto end;
     }
-    err = EIS(libis_lookahead(libj->libis, input, &eof, 1, &c));
+    err = E(parse_string(parser, &value, &value_size));
     if (err) goto end;
-    if ('0' <= c && c <= '9') {
-        char t = c;
-        err = EGB(libgb_append_buffer(libj->libgb, buffer, &t, 1));
-        if (err) goto end;
-        err = EIS(libis_skip_char(libj->libis, input, &eof, &c));
-        if (err) goto end;
-    } else {
-        E(errorf(libj, "a digit was expected", 0));
-        err = LIBJ_ERROR_SYNTAX;
+    if (parser->handler->on_string && !parser->handler->on_string(parser->user, value, value_size)) {
+        err = LIBJ_ERROR_STOPPED;
         goto end;
     }
 end:
     return err;
 }
 
-static LibjError consume_digits(Libj *libj, LibisInputStream *input, LibgbBuffer *buffer) {
+/* Append bytes of number to buffer. buffer is NULL when number is read in place instead of being copied. */
+static LibjError append_to_buffer(Libj *libj, LibjScratch *buffer, const char *bytes, size_t size) {
     LibjError err = LIBJ_ERROR_OK;
-    char c;
-    bool eof;
-    if (!libj || !input || !buffer) {
+    if (!libj || !bytes) {
         err = LIBJ_ERROR_BAD_ARGUMENT;
         goto end;
     }
-    err = EIS(libis_lookahead(libj->libis, input, &eof, 1, &c));
-    if (err) goto end;
-    while ('0' <= c && c <= '9') {
-        char t = c;
-        err = EGB(libgb_append_buffer(libj->libgb, buffer, &t, 1));
-        if (err) goto end;
-        err = EIS(libis_skip_char(libj->libis, input, &eof, &c));
-        if (err) goto end;
+    if (!buffer) {
+        goto end;
     }
+    err = E(scratch_append(buffer, bytes, size));
+    if (err) goto end;
 end:
     return err;
 }
 
-static LibjError consume_integer(Libj *libj, LibisInputStream *input, LibgbBuffer *buffer) {
+LibjError libj_parse_key(LibjParser *parser) {
     LibjError err = LIBJ_ERROR_OK;
-    char c;
-    bool eof;
-    if (!libj || !input || !buffer) {
+    const char *name;
+    size_t name_size;
+    if (!parser) {
         err = LIBJ_ERROR_BAD_ARGUMENT;
         goto end;
     }
-    err = EIS(libis_lookahead(libj->libis, input, &eof, 1, &c));
+    err = E(parse_string(parser, &name, &name_size));
     if (err) goto end;
-    if ('-' == c) {
-        err = EGB(libgb_append_buffer(libj->libgb, buffer, &c, 1));
-        if (err) goto end;
-        err = EIS(libis_skip_char(libj->libis, input, &eof, &c));
-        if (err) goto end;
-    }
-    if ('0' == c) {
-        err = EGB(libgb_append_buffer(libj->libgb, buffer, &c, 1));
-        if (err) goto end;
-        err = EIS(libis_skip_char(libj->libis, input, &eof, &c));
-        if (err) goto end;
+    if (parser->handler->on_key && !parser->handler->on_key(parser->user, name, name_size)) {
+        err = LIBJ_ERROR_STOPPED;
         goto end;
-    } else {
-        err = E(consume_digit(libj, input, buffer));
-        if (err) goto end;
-        err = E(consume_digits(libj, input, buffer));
-        if (err) goto end;
     }
 end:
     return err;
 }
 
-static LibjError consume_fractional(Libj *libj, LibisInputStream *input, LibgbBuffer *buffer) {
+LibjError libj_parse_value_object(LibjParser *parser) {
     LibjError err = LIBJ_ERROR_OK;
-    locale_t previous_locale = uselocale(0);
     char c;
     bool eof;
-    if (!libj || !input || !buffer) {
+    if (!parser) {
         err = LIBJ_ERROR_BAD_ARGUMENT;
         goto end;
     }
-    uselocale(libj->c_locale);
-    err = EIS(libis_lookahead(libj->libis, input, &eof, 1, &c));
+    Libj *libj = parser->libj;
+    LibjInput *input = parser->input;
+    const LibjHandler *handler = parser->handler;
+    err = E(libj_skip_literal(libj, input, "{"));
     if (err) goto end;
-    if ('.' == c) {
-        struct lconv *lconv = localeconv();
-        err = EGB(libgb_append_buffer(libj->libgb, buffer, lconv->decimal_point, strlen(lconv->decimal_point)));
+    if (handler->on_object_start && !handler->on_object_start(parser->user)) {
+        err = LIBJ_ERROR_STOPPED;
+        goto end;
+    }
+    err = libj_skip_whitespace(libj, input, &eof, &c);
+    if (err) goto end;
+    if ('}' == c) {
+        err = E(libj_skip_literal(libj, input, "}"));
         if (err) goto end;
-        err = EIS(libis_skip_char(libj->libis, input, &eof, &c));
+        goto done;
+    }
+    if (libj->depth == LIBJ_MAX_DEPTH) {
+        err = LIBJ_ERROR_SYNTAX;
+        E(errorf(libj, "too many nesting levels", 0));
+        goto end;
+    }
+    ++libj->depth;
+    for (;;) {
+        err = E(libj_parse_key(parser));
         if (err) goto end;
-        err = E(consume_digit(libj, input, buffer));
+        err = E(libj_skip_literal(libj, input, ":"));
         if (err) goto end;
-        err = E(consume_digits(libj, input, buffer));
+        err = E(libj_parse_value(parser));
         if (err) goto end;
-    }
-end:
-    uselocale(previous_locale);
-    return err;
+        err = libj_skip_whitespace(libj, input, &eof, &c);
+        if (err) goto end;
+        if ('}' != c && ',' != c) {
+            E(errorf(libj, "} or , was expected", 0));
+            err = LIBJ_ERROR_SYNTAX;
+            goto end;
+        }
+        if ('}' == c) {
+            err = E(libj_skip_literal(libj, input, "}"));
+            if (err) goto end;
+            break;
+        }
+        err = libj_input_skip_char(libj, input, &eof, &c);
+        if (err) goto end;
+    }
+    --libj->depth;
+done:
+    if (handler->on_object_end && !handler->on_object_end(parser->user)) {
+        err = LIBJ_ERROR_STOPPED;
+        goto end;
+    }
+end:
+    return err;
 }
 
-static LibjError consume_exponent(Libj *libj, LibisInputStream *input, LibgbBuffer *buffer) {
+LibjError libj_parse_value_array(LibjParser *parser) {
     LibjError err = LIBJ_ERROR_OK;
     char c;
     bool eof;
-    if (!libj || !input || !buffer) {
+    if (!parser) {
+        err = LIBJ_ERROR_BAD_ARGUMENT;
+        goto end;
+    }
+    Libj *libj = parser->libj;
+    LibjInput *input = parser->input;
+    const LibjHandler *handler = parser->handler;
+    err = E(libj_skip_literal(libj, input, "["));
+    if (err) goto end;
+    if (handler->on_array_start && !handler->on_array_start(parser->user)) {
+        err = LIBJ_ERROR_STOPPED;
+        goto end;
+    }
+    err = libj_skip_whitespace(libj, input, &eof, &c);
+    if (err) goto end;
+    if (']' == c) {
+        err = E(libj_skip_literal(libj, input, "]"));
+        if (err) goto end;
+        goto done;
+    }
+    if (libj->depth == LIBJ_MAX_DEPTH) {
+        err = LIBJ_ERROR_SYNTAX;
+        E(errorf(libj, "too many nesting levels", 0));
+        goto end;
+    }
+    ++libj->depth;
+    for (;;) {
+        err = E(libj_parse_value(parser));
+        if (err) goto end;
+        err = libj_skip_whitespace(libj, input, &eof, &c);
+        if (err) goto end;
+        if (']' != c && ',' != c) {
+            E(errorf(libj, "] or , was expected", 0));
+            err = LIBJ_ERROR_SYNTAX;
+            goto end;
+        }
+        if (']' == c) {
+            err = E(libj_skip_literal(libj, input, "]"));
+            if (err) goto end;
+            break;
+        }
+        err = libj_input_skip_char(libj, input, &eof, &c);
+        if (err) goto end;
+    }
+    --libj->depth;
+done:
+    if (handler->on_array_end && !handler->on_array_end(parser->user)) {
+        err = LIBJ_ERROR_STOPPED;
+        goto end;
+    }
+end:
+    return err;
+}
+
+LibjError libj_parse_value_true(LibjParser *parser) {
+    LibjError err = LIBJ_ERROR_OK;
+    if (!parser) {
+        err = LIBJ_ERROR_BAD_ARGUMENT;
+        goto end;
+    }
+    err = E(libj_skip_literal(parser->libj, parser->input, "true"));
+    if (err) goto end;
+    if (parser->handler->on_bool && !parser->handler->on_bool(parser->user, true)) {
+        err = LIBJ_ERROR_STOPPED;
+        goto end;
+    }
+end:
+    return err;
+}
+
+LibjError libj_parse_value_false(LibjParser *parser) {
+    LibjError err = LIBJ_ERROR_OK;
+    if (!parser) {
+        err = LIBJ_ERROR_BAD_ARGUMENT;
+        goto end;
+    }
+    err = E(libj_skip_literal(parser->libj, parser->input, "false"));
+    if (err) goto end;
+    if (parser->handler->on_bool && !parser->handler->on_bool(parser->user, false)) {
+        err = LIBJ_ERROR_STOPPED;
+        goto end;
+    }
+end:
+    return err;
+}
+
+LibjError libj_parse_value_null(LibjParser *parser) {
+    LibjError err = LIBJ_ERROR_OK;
+    if (!parser) {
+        err = LIBJ_ERROR_BAD_ARGUMENT;
+        goto end;
+    }
+    err = E(libj_skip_literal(parser->libj, parser->input, "null"));
+    if (err) goto end;
+    if (parser->handler->on_null && !parser->handler->on_null(parser->user)) {
+        err = LIBJ_ERROR_STOPPED;
+        goto end;
+    }
+end:
+    return err;
+}
+
+static LibjError consume_sign(Libj *libj, LibjInput *input, LibjScratch *buffer) {
+    LibjError err = LIBJ_ERROR_OK;
+    char c;
+    bool eof;
+    if (!libj || !input) {
+        err = LIBJ_ERROR_BAD_ARGUMENT;
+        goto end;
+    }
+    err = libj_input_lookahead(libj, input, &eof, &c);
+    if (err) goto end;
+    if ('+' == c || '-' == c) {
+        char t = c;
+        err = E(append_to_buffer(libj, buffer, &t, 1));
+        if (err) goto end;
+        err = libj_input_skip_char(libj, input, &eof, &c);
+        if (err) goto end;
+    }
+end:
+    return err;
+}
+
+static LibjError consume_digit(Libj *libj, LibjInput *input, LibjScratch *buffer) {
+    LibjError err = LIBJ_ERROR_OK;
+    char c;
+    bool eof;
+    if (!libj || !input) {
+        err = LIBJ_ERROR_BAD_ARGUMENT;
+        goto end;
+    }
+    err = libj_input_lookahead(libj, input, &eof, &c);
+    if (err) goto end;
+    if ('0' <= c && c <= '9') {
+        char t = c;
+        err = E(append_to_buffer(libj, buffer, &t, 1));
+        if (err) goto end;
+        err = libj_input_skip_char(libj, input, &eof, &c);
+        if (err) goto end;
+    } else {
+        E(errorf(libj, "a digit was expected", 0));
+        err = LIBJ_ERROR_SYNTAX;
+        goto end;
+    }
+end:
+    return err;
+}
+
+/* Consume digits as long as there are any. If magnitude isn't NULL the digits are accumulated into it as a
+ * decimal number. *overflow is set when it doesn't fit. */
+static LibjError consume_digits(Libj *libj, LibjInput *input, LibjScratch *buffer, uint64_t *magnitude,
+                                bool *overflow) {
+    LibjError err = LIBJ_ERROR_OK;
+    uint64_t value = magnitude ? *magnitude : 0;
+    bool value_overflow = overflow ? *overflow : false;
+    char c;
+    bool eof;
+    if (!libj || !input) {
+        err = LIBJ_ERROR_BAD_ARGUMENT;
+        goto end;
+    }
+    if (!input->stream) {
+        /* Digits are taken from buffer input in one run. */
+        const char *begin = input->current;
+        const char *p = begin;
+        for (; p != input->end && '0' <= *p && *p <= '9'; ++p) {
+            unsigned digit = *p - '0';
+            value_overflow = value_overflow || (UINT64_MAX - digit) / 10 < value;
+            value = 10 * value + digit;
+        }
+        err = E(append_to_buffer(libj, buffer, begin, p - begin));
+        if (err) goto end;
+        input->current = p;
+        goto end;
+    }
+    err = libj_input_lookahead(libj, input, &eof, &c);
+    if (err) goto end;
+    while ('0' <= c && c <= '9') {
+        unsigned digit = c - '0';
+        value_overflow = value_overflow || (UINT64_MAX - digit) / 10 < value;
+        value = 10 * value + digit;
+        char t = c;
+        err = E(append_to_buffer(libj, buffer, &t, 1));
+        if (err) goto end;
+        err = libj_input_skip_char(libj, input, &eof, &c);
+        if (err) goto end;
+    }
+end:
+    if (magnitude) *magnitude = value;
+    if (overflow) *overflow = value_overflow;
+    return err;
+}
+
+/* Consume integer part of a number and convert it into *value on the way. *exact is false when the integer
+ * doesn't fit into int64_t, *value is clamped then. */
+static LibjError consume_integer(Libj *libj, LibjInput *input, LibjScratch *buffer, int64_t *value, bool *exact) {
+    LibjError err = LIBJ_ERROR_OK;
+    uint64_t magnitude = 0;
+    bool negative = false;
+    bool overflow = false;
+    char c;
+    bool eof;
+    if (!libj || !input || !value || !exact) {
         err = LIBJ_ERROR_BAD_ARGUMENT;
         goto end;
     }
-    err = EIS(libis_lookahead(libj->libis, input, &eof, 1, &c));
+    err = libj_input_lookahead(libj, input, &eof, &c);
+    if (err) goto end;
+    if ('-' == c) {
+        negative = true;
+        err = E(append_to_buffer(libj, buffer, &c, 1));
+        if (err) goto end;
+        err = libj_input_skip_char(libj, input, &eof, &c);
+        if (err) goto end;
+    }
+    if ('0' == c) {
+        err = E(append_to_buffer(libj, buffer, &c, 1));
+        if (err) goto end;
+        err = libj_input_skip_char(libj, input, &eof, &c);
+        if (err) goto end;
+    } else if ('0' <= c && c <= '9') {
+        err = E(consume_digits(libj, input, buffer, &magnitude, &overflow));
+        if (err) goto end;
+    } else {
+        E(errorf(libj, "a digit was expected", 0));
+        err = LIBJ_ERROR_SYNTAX;
+        goto end;
+    }
+    if (overflow || magnitude > (uint64_t) INT64_MAX + negative) {
+        *value = negative ? INT64_MIN : INT64_MAX;
+        *exact = false;
+    } else {
+        *value = negative ? (int64_t) (0 - magnitude) : (int64_t) magnitude;
+        *exact = true;
+    }
+end:
+    return err;
+}
+
+static LibjError consume_fractional(Libj *libj, LibjInput *input, LibjScratch *buffer) {
+    LibjError err = LIBJ_ERROR_OK;
+    char c;
+    bool eof;
+    if (!libj || !input) {
+        err = LIBJ_ERROR_BAD_ARGUMENT;
+        goto end;
+    }
+    err = libj_input_lookahead(libj, input, &eof, &c);
+    if (err) goto end;
+    if ('.' == c) {
+        /* Text of numbers keeps json's decimal point whatever the locale is. */
+        err = E(append_to_buffer(libj, buffer, &c, 1));
+        if (err) goto end;
+        err = libj_input_skip_char(libj, input, &eof, &c);
+        if (err) goto end;
+        err = E(consume_digit(libj, input, buffer));
+        if (err) goto end;
+        err = E(consume_digits(libj, input, buffer, NULL, NULL));
+        if (err) goto end;
+    }
+end:
+    return err;
+}
+
+static LibjError consume_exponent(Libj *libj, LibjInput *input, LibjScratch *buffer) {
+    LibjError err = LIBJ_ERROR_OK;
+    char c;
+    bool eof;
+    if (!libj || !input) {
+        err = LIBJ_ERROR_BAD_ARGUMENT;
+        goto end;
+    }
+    err = libj_input_lookahead(libj, input, &eof, &c);
     if (err) goto end;
     if ('e' == c || 'E' == c) {
         char t = c;
-        err = EGB(libgb_append_buffer(libj->libgb, buffer, &t, 1));
+        err = E(append_to_buffer(libj, buffer, &t, 1));
         if (err) goto end;
-        err = EIS(libis_skip_char(libj->libis, input, &eof, &c));
+        err = libj_input_skip_char(libj, input, &eof, &c);
         if (err) goto end;
         err = E(consume_sign(libj, input, buffer));
         if (err) goto end;
         err = E(consume_digit(libj, input, buffer));
         if (err) goto end;
-        err = E(consume_digits(libj, input, buffer));
+        err = E(consume_digits(libj, input, buffer, NULL, NULL));
         if (err) goto end;
     }
 end:
     return err;
 }
 
-LibjError libj_parse_value_number(Libj *libj, LibjJson **json, LibisInputStream *input) {
+/* Drop text of number in typed mode if its value can stand for it. */
+static bool number_keep_value(LibjNumber *number, const char *text, size_t text_size) {
+    if (number->decoded & LIBJ_NUMBER_INTEGER_EXACT) {
+        return true;
+    }
+    /* Integers that don't fit into int64_t keep their digits. */
+    if (number->decoded & LIBJ_NUMBER_INTEGER_DECODED) {
+        return false;
+    }
+    double real;
+    if (!libj_parse_double(text, text_size, &real)) {
+        return false;
+    }
+    number->real = real;
+    number->decoded = LIBJ_NUMBER_REAL_DECODED | LIBJ_NUMBER_REAL_EXACT | LIBJ_NUMBER_REAL_VALUE;
+    return true;
+}
+
+LibjError libj_use_typed_numbers(Libj *libj, bool enable) {
     LibjError err = LIBJ_ERROR_OK;
-    LibgbBuffer *buffer = NULL;
-    LibjJson *json_number = NULL;
-    if (!libj || !json || !input) {
+    if (!libj) {
         err = LIBJ_ERROR_BAD_ARGUMENT;
         goto end;
     }
-    err = EGB(libgb_create(libj->libgb, &buffer));
+    libj->typed_numbers = enable;
+end:
+    return err;
+}
+
+LibjError libj_parse_value_number(LibjParser *parser) {
+    LibjError err = LIBJ_ERROR_OK;
+    if (!parser) {
+        err = LIBJ_ERROR_BAD_ARGUMENT;
+        goto end;
+    }
+    Libj *libj = parser->libj;
+    LibjInput *input = parser->input;
+    /* Text of number is exactly its bytes in buffer input so it's read in place. Only streams collect it. */
+    bool in_place = !input->stream;
+    const char *number_begin = input->current;
+    LibjScratch *buffer = NULL;
+    if (!in_place) {
+        buffer = &parser->scratch;
+        buffer->size = 0;
+    }
+    int64_t integer;
+    bool exact;
+    err = E(consume_integer(libj, input, buffer, &integer, &exact));
     if (err) goto end;
-    err = E(consume_integer(libj, input, buffer));
+    char c;
+    bool eof;
+    err = libj_input_lookahead(libj, input, &eof, &c);
     if (err) goto end;
+    /* Value of a number without fraction and exponent is known already. */
+    unsigned decoded = 0;
+    if ('.' != c && 'e' != c && 'E' != c) {
+        decoded = LIBJ_NUMBER_INTEGER_DECODED | (exact ? LIBJ_NUMBER_INTEGER_EXACT : 0);
+    }
     err = E(consume_fractional(libj, input, buffer));
     if (err) goto end;
     err = E(consume_exponent(libj, input, buffer));
     if (err) goto end;
-    char null = '\0';
-    err = EGB(libgb_append_buffer(libj->libgb, buffer, &null, 1));
-    if (err) goto end;
-    json_number = malloc(sizeof(LibjJson));
-    if (!json_number) {
-        err = LIBJ_ERROR_OUT_OF_MEMORY;
+    parser->in_input = in_place;
+    parser->integer = integer;
+    parser->decoded = decoded;
+    const char *text = in_place ? number_begin : buffer->bytes;
+    size_t text_size = in_place ? (size_t) (input->current - number_begin) : buffer->size;
+    if (parser->handler->on_number && !parser->handler->on_number(parser->user, text, text_size)) {
+        err = LIBJ_ERROR_STOPPED;
         goto end;
     }
-    json_number->type = LIBJ_TYPE_NUMBER;
-    err = EGB(libgb_destroy_into(libj->libgb, &buffer, &json_number->string.value, &json_number->string.size));
-    if (err) goto end;
-    *json = json_number;
-    json_number = NULL;
 end:
-    free(json_number);
-    EGB(libgb_destroy(libj->libgb, &buffer));
     return err;
 }
 
-LibjError libj_parse_value(Libj *libj, LibjJson **json, LibisInputStream *input) {
+LibjError libj_parse_value(LibjParser *parser) {
     LibjError err = LIBJ_ERROR_OK;
     char c;
     bool eof;
-    if (!libj || !json || !input) {
+    if (!parser) {
         err = LIBJ_ERROR_BAD_ARGUMENT;
         goto end;
     }
-    err = libj_skip_whitespace(libj, input, &eof, &c);
+    err = libj_skip_whitespace(parser->libj, parser->input, &eof, &c);
     if (err) goto end;
     switch (c) {
     case '{':
-        err = E(libj_parse_value_object(libj, json, input));
+        err = E(libj_parse_value_object(parser));
         break;
     case '[':
-        err = E(libj_parse_value_array(libj, json, input));
+        err = E(libj_parse_value_array(parser));
         break;
     case 't':
-        err = E(libj_parse_value_true(libj, json, input));
+        err = E(libj_parse_value_true(parser));
         break;
     case 'f':
-        err = E(libj_parse_value_false(libj, json, input));
+        err = E(libj_parse_value_false(parser));
         break;
     case 'n':
-        err = E(libj_parse_value_null(libj, json, input));
+        err = E(libj_parse_value_null(parser));
         break;
     case '"':
-        err = E(libj_parse_value_string(libj, json, input));
+        err = E(libj_parse_value_string(parser));
         break;
     case '-':
     case '0':
@@ -703,10 +1041,10 @@ LibjError libj_parse_value(Libj *libj, LibjJson **json, LibisInputStream *input)
     case '7':
     case '8':
     case '9':
-        err = E(libj_parse_value_number(libj, json, input));
+        err = E(libj_parse_value_number(parser));
         break;
     default:
-        E(errorf(libj, "json value was expected", 0));
+        E(errorf(parser->libj, "json value was expected", 0));
         err = LIBJ_ERROR_SYNTAX;
         break;
     }
@@ -718,28 +1056,7 @@ LibjError libj_from_string(Libj *libj, LibjJson **json, const char *input_string
     return E(libj_from_string_ex(libj, json, input_string, strlen(input_string), error_string));
 }
 
-LibjError libj_from_string_ex(Libj *libj, LibjJson **json,
-                              const char *input_string, size_t input_size,
-                              const char **error_string) {
-    LibjError err = LIBJ_ERROR_OK;
-    LibisSource *source = NULL;
-    LibisInputStream *input = NULL;
-    if (!libj || !json || !input_string) {
-        err = LIBJ_ERROR_BAD_ARGUMENT;
-        goto end;
-    }
-    err = EIS(libis_source_create_from_buffer(libj->libis, &source, input_string, input_size, false));
-    if (err) goto end;
-    err = EIS(libis_create(libj->libis, &input, &source, 1));
-    if (err) goto end;
-    err = E(libj_from_input_stream(libj, json, input, error_string));
-    if (err) goto end;
-end:
-    if (libj) EIS(libis_destroy(libj->libis, &input));
-    return err;
-}
-
-LibjError libj_skip_bom(Libj *libj, LibisInputStream *input) {
+LibjError libj_skip_bom(Libj *libj, LibjInput *input) {
     LibjError err = LIBJ_ERROR_OK;
     static const char *bom = "\xEF\xBB\xBF";
     char c;
@@ -748,12 +1065,12 @@ LibjError libj_skip_bom(Libj *libj, LibisInputStream *input) {
         err = LIBJ_ERROR_BAD_ARGUMENT;
         goto end;
     }
-    err = EIS(libis_lookahead(libj->libis, input, &eof, 1, &c));
+    err = libj_input_lookahead(libj, input, &eof, &c);
     if (err) goto end;
     if (c != bom[0]) {
         goto end;
     }
-    err = EIS(libis_skip_char(libj->libis, input, &eof, &c));
+    err = libj_input_skip_char(libj, input, &eof, &c);
     if (err) goto end;
     if (c == EOF) {
         err = LIBJ_ERROR_SYNTAX;
@@ -765,7 +1082,7 @@ LibjError libj_skip_bom(Libj *libj, LibisInputStream *input) {
         E(errorf(libj, "unexpected byte '%c'(0x%02X)", c));
         goto end;
     }
-    err = EIS(libis_skip_char(libj->libis, input, &eof, &c));
+    err = libj_input_skip_char(libj, input, &eof, &c);
     if (err) goto end;
     if (c == EOF) {
         err = LIBJ_ERROR_SYNTAX;
@@ -781,28 +1098,358 @@ end:
     return err;
 }
 
-LibjError libj_from_input_stream(Libj *libj, LibjJson **json, LibisInputStream *input, const char **error_string) {
+void parser_init(LibjParser *parser, Libj *libj, LibjInput *input, const LibjHandler *handler, void *user) {
+    parser->libj = libj;
+    parser->input = input;
+    parser->handler = handler;
+    parser->user = user;
+    parser->scratch.bytes = NULL;
+    parser->scratch.size = 0;
+    parser->scratch.capacity = 0;
+    parser->in_input = false;
+    parser->integer = 0;
+    parser->decoded = 0;
+}
+
+/* Parse single json value from input of parser and pass it to its handler. Scratch of parser is released
+ * afterwards. */
+static LibjError parse_events(LibjParser *parser, const char **error_string) {
     LibjError err = LIBJ_ERROR_OK;
-    if (!libj || !json || !input || !error_string) {
+    if (!parser || !error_string) {
         err = LIBJ_ERROR_BAD_ARGUMENT;
         goto end;
     }
+    Libj *libj = parser->libj;
     free(libj->error_string);
     libj->error_string = NULL;
-    err = E(libj_skip_bom(libj, input));
-    if (err) {
-        *error_string = libj->error_string;
+    err = E(libj_skip_bom(libj, parser->input));
+    if (err) goto end;
+    libj->depth = 0;
+    err = E(libj_parse_value(parser));
+    if (err) goto end;
+    *error_string = "";
+    assert(!libj->depth);
+end:
+    /* Errors without a message of their own, such as a callback stopping parsing, are described by the table. */
+    if (err && parser && error_string) {
+        const char *message = parser->libj->error_string;
+        *error_string = message ? message : libj_error_to_human_readable_string(err);
+    }
+    if (parser) {
+        free(parser->scratch.bytes);
+        parser->scratch.bytes = NULL;
+        parser->scratch.size = 0;
+        parser->scratch.capacity = 0;
+    }
+    return err;
+}
+
+LibjError libj_parse_events(Libj *libj, const char *input_string, size_t input_size, const LibjHandler *handler,
+                            void *user, const char **error_string) {
+    LibjError err = LIBJ_ERROR_OK;
+    LibjInput input;
+    LibjParser parser;
+    if (!libj || !input_string || !handler || !error_string) {
+        err = LIBJ_ERROR_BAD_ARGUMENT;
         goto end;
     }
-    libj->depth = 0;
-    err = E(libj_parse_value(libj, json, input));
-    if (err) {
-        *error_string = libj->error_string;
+    libj_input_from_buffer(&input, input_string, input_size);
+    parser_init(&parser, libj, &input, handler, user);
+    err = E(parse_events(&parser, error_string));
+    if (err) goto end;
+end:
+    return err;
+}
+
+LibjError libj_parse_events_from_input_stream(Libj *libj, LibisInputStream *input, const LibjHandler *handler,
+                                              void *user, const char **error_string) {
+    LibjError err = LIBJ_ERROR_OK;
+    LibjInput stream_input;
+    LibjParser parser;
+    if (!libj || !input || !handler || !error_string) {
+        err = LIBJ_ERROR_BAD_ARGUMENT;
         goto end;
     }
-    *error_string = "";
-    assert(!libj->depth);
+    libj_input_from_stream(&stream_input, input);
+    parser_init(&parser, libj, &stream_input, handler, user);
+    err = E(parse_events(&parser, error_string));
+    if (err) goto end;
 end:
     return err;
 }
 
+void builder_init(LibjBuilder *builder, Libj *libj, LibjParser *parser) {
+    builder->libj = libj;
+    builder->parser = parser;
+    builder->err = LIBJ_ERROR_OK;
+    builder->root = NULL;
+    builder->depth = 0;
+    builder->name.size = 0;
+    builder->name.value = NULL;
+    builder->name.storage = LIBJ_STRING_OWNED;
+}
+
+void builder_free(LibjBuilder *builder) {
+    if (!builder->libj) {
+        return;
+    }
+    string_release(builder->libj->document, &builder->name);
+    E(libj_free_json(builder->libj, &builder->root));
+}
+
+/* Make string out of bytes passed by the parser. They are referred to when they are in input and strings of
+ * input aren't copied. */
+static LibjError builder_string(LibjBuilder *builder, const char *value, size_t value_size, LibjString *string) {
+    LibjError err = LIBJ_ERROR_OK;
+    if (!builder || !value || !string) {
+        err = LIBJ_ERROR_BAD_ARGUMENT;
+        goto end;
+    }
+    LibjStringStorage strings = builder->parser->input->strings;
+    if (builder->parser->in_input && LIBJ_STRING_OWNED != strings) {
+        string->value = (char *) value;
+        string->size = value_size;
+        string->storage = strings;
+        goto end;
+    }
+    err = E(libj_string_duplicate(builder->libj, builder->libj->document, value, value_size, &string->value));
+    if (err) goto end;
+    string->size = value_size;
+    string->storage = LIBJ_STRING_OWNED;
+end:
+    return err;
+}
+
+/* Add json to the innermost open container or make it root. */
+static LibjError builder_add(LibjBuilder *builder, LibjJson **json) {
+    LibjError err = LIBJ_ERROR_OK;
+    if (!builder || !json || !*json) {
+        err = LIBJ_ERROR_BAD_ARGUMENT;
+        goto end;
+    }
+    if (!builder->depth) {
+        builder->root = *json;
+        *json = NULL;
+        goto end;
+    }
+    LibjJson *parent = builder->containers[builder->depth - 1];
+    if (LIBJ_TYPE_ARRAY == parent->type) {
+        err = E(libj_array_add_take(builder->libj, parent, json));
+        if (err) goto end;
+    } else {
+        err = E(object_insert_at_take(builder->libj, parent, parent->object.size, &builder->name, json));
+        if (err) goto end;
+    }
+end:
+    return err;
+}
+
+/* Add json which is done and release it if it couldn't be added. */
+static bool builder_value(LibjBuilder *builder, LibjError err, LibjJson *json) {
+    if (err) goto end;
+    err = E(builder_add(builder, &json));
+    if (err) goto end;
+end:
+    E(libj_free_json(builder->libj, &json));
+    builder->err = err;
+    return !err;
+}
+
+/* Add container and make it the innermost one. */
+static bool builder_start(LibjBuilder *builder, LibjError err, LibjJson *json) {
+    LibjJson *container = json;
+    if (err) goto end;
+    err = E(builder_add(builder, &json));
+    if (err) goto end;
+    builder->containers[builder->depth++] = container;
+end:
+    E(libj_free_json(builder->libj, &json));
+    builder->err = err;
+    return !err;
+}
+
+static bool build_null(void *user) {
+    LibjBuilder *builder = user;
+    LibjJson *json = NULL;
+    LibjError err = E(libj_null_create(builder->libj, &json));
+    return builder_value(builder, err, json);
+}
+
+static bool build_bool(void *user, bool value) {
+    LibjBuilder *builder = user;
+    LibjJson *json = NULL;
+    LibjError err = E(libj_bool_create(builder->libj, &json, value));
+    return builder_value(builder, err, json);
+}
+
+static bool build_number(void *user, const char *text, size_t text_size) {
+    LibjBuilder *builder = user;
+    LibjParser *parser = builder->parser;
+    LibjJson *json = NULL;
+    LibjError err = E(json_create(builder->libj, builder->libj->document, LIBJ_TYPE_NUMBER, &json));
+    if (err) goto end;
+    LibjNumber *number = &json->number;
+    number->integer = parser->integer;
+    number->decoded = parser->decoded;
+    /* Typed numbers leave text NULL unless their value can't stand for it. */
+    if (builder->libj->typed_numbers && number_keep_value(number, text, text_size)) {
+        text = NULL;
+    } else {
+        err = E(builder_string(builder, text, text_size, &number->text));
+        if (err) goto end;
+        /* Text of a number is never unescaped, so strings referring to input make it a plain view. */
+        if (LIBJ_STRING_OWNED != number->text.storage) {
+            number->text.storage = LIBJ_STRING_VIEW;
+        }
+    }
+    err = E(number_decode(builder->libj, number, text, text_size));
+    if (err) goto end;
+end:
+    return builder_value(builder, err, json);
+}
+
+static bool build_string(void *user, const char *value, size_t value_size) {
+    LibjBuilder *builder = user;
+    LibjJson *json = NULL;
+    LibjError err = E(json_create(builder->libj, builder->libj->document, LIBJ_TYPE_STRING, &json));
+    if (err) goto end;
+    err = E(builder_string(builder, value, value_size, &json->string));
+    if (err) goto end;
+end:
+    return builder_value(builder, err, json);
+}
+
+static bool build_object_start(void *user) {
+    LibjBuilder *builder = user;
+    LibjJson *json = NULL;
+    LibjError err = E(libj_object_create(builder->libj, &json));
+    return builder_start(builder, err, json);
+}
+
+static bool build_array_start(void *user) {
+    LibjBuilder *builder = user;
+    LibjJson *json = NULL;
+    LibjError err = E(libj_array_create(builder->libj, &json));
+    return builder_start(builder, err, json);
+}
+
+static bool build_key(void *user, const char *name, size_t name_size) {
+    LibjBuilder *builder = user;
+    LibjError err = LIBJ_ERROR_OK;
+    if (builder->libj->interning) {
+        err = E(string_intern(builder->libj, name, name_size, &builder->name));
+        if (err) goto end;
+    }
+    if (!builder->name.value) {
+        err = E(builder_string(builder, name, name_size, &builder->name));
+        if (err) goto end;
+    }
+end:
+    builder->err = err;
+    return !err;
+}
+
+static bool build_end(void *user) {
+    LibjBuilder *builder = user;
+    --builder->depth;
+    return true;
+}
+
+const LibjHandler builder_handler = {
+        .on_null = build_null,
+        .on_bool = build_bool,
+        .on_number = build_number,
+        .on_string = build_string,
+        .on_object_start = build_object_start,
+        .on_key = build_key,
+        .on_object_end = build_end,
+        .on_array_start = build_array_start,
+        .on_array_end = build_end,
+};
+
+/* Parse single json value from input. */
+static LibjError parse(Libj *libj, LibjJson **json, LibjInput *input, const char **error_string) {
+    LibjError err = LIBJ_ERROR_OK;
+    LibjParser parser;
+    LibjBuilder builder;
+    builder_init(&builder, libj, &parser);
+    if (!libj || !json || !input || !error_string) {
+        err = LIBJ_ERROR_BAD_ARGUMENT;
+        goto end;
+    }
+    parser_init(&parser, libj, input, &builder_handler, &builder);
+    err = E(parse_events(&parser, error_string));
+    /* Callbacks of the builder stop parsing only because of their own errors. */
+    if (LIBJ_ERROR_STOPPED == err) {
+        err = builder.err;
+        *error_string = libj_error_to_human_readable_string(err);
+    }
+    if (err) goto end;
+    *json = builder.root;
+    builder.root = NULL;
+end:
+    builder_free(&builder);
+    return err;
+}
+
+LibjError libj_from_string_ex(Libj *libj, LibjJson **json,
+                              const char *input_string, size_t input_size,
+                              const char **error_string) {
+    LibjError err = LIBJ_ERROR_OK;
+    LibjInput input;
+    if (!libj || !json || !input_string || !error_string) {
+        err = LIBJ_ERROR_BAD_ARGUMENT;
+        goto end;
+    }
+    libj_input_from_buffer(&input, input_string, input_size);
+    err = E(parse(libj, json, &input, error_string));
+    if (err) goto end;
+end:
+    return err;
+}
+
+LibjError libj_from_input_stream(Libj *libj, LibjJson **json, LibisInputStream *input, const char **error_string) {
+    LibjError err = LIBJ_ERROR_OK;
+    LibjInput stream_input;
+    if (!libj || !json || !input || !error_string) {
+        err = LIBJ_ERROR_BAD_ARGUMENT;
+        goto end;
+    }
+    libj_input_from_stream(&stream_input, input);
+    err = E(parse(libj, json, &stream_input, error_string));
+    if (err) goto end;
+end:
+    return err;
+}
+
+LibjError libj_from_buffer_insitu(Libj *libj, LibjJson **json, char *buffer, size_t buffer_size,
+                                  const char **error_string) {
+    LibjError err = LIBJ_ERROR_OK;
+    LibjInput input;
+    if (!libj || !json || !buffer || !error_string) {
+        err = LIBJ_ERROR_BAD_ARGUMENT;
+        goto end;
+    }
+    libj_input_from_buffer(&input, buffer, buffer_size);
+    input.strings = LIBJ_STRING_INSITU;
+    err = E(parse(libj, json, &input, error_string));
+    if (err) goto end;
+end:
+    return err;
+}
+
+LibjError libj_from_buffer_view(Libj *libj, LibjJson **json, const char *buffer, size_t buffer_size,
+                                const char **error_string) {
+    LibjError err = LIBJ_ERROR_OK;
+    LibjInput input;
+    if (!libj || !json || !buffer || !error_string) {
+        err = LIBJ_ERROR_BAD_ARGUMENT;
+        goto end;
+    }
+    libj_input_from_buffer(&input, buffer, buffer_size);
+    input.strings = LIBJ_STRING_VIEW;
+    err = E(parse(libj, json, &input, error_string));
+    if (err) goto end;
+end:
+    return err;
+}
@@ -0,0 +1,207 @@
+#include "libj_internal.h"
+
+#include <stddef.h>
+#include <string.h>
+
+/* Number of slots the table starts with. */
+#define SYMBOL_TABLE_MIN_SLOTS 64
+
+/* Number of symbols past which member names aren't interned implicitly anymore. Input with ever new member names
+ * would grow the table until libj_finish() otherwise. */
+#define SYMBOL_TABLE_MAX_IMPLICIT ((size_t) 1 << 16)
+
+/* Set of member names. Symbols are allocated from a document of the table and are never released one by one, so
+ * pointers to them stay valid until the table is freed with its libj. */
+struct LibjSymbolTable_ {
+    LibjDocument *storage;
+    size_t slot_count; /* power of two */
+    size_t used_slots;
+    LibjSymbol **slots; /* NULL for an empty slot */
+};
+
+uint64_t name_hash(const char *name, size_t name_size) {
+    uint64_t hash = UINT64_C(14695981039346656037);
+    for (size_t i = 0; i < name_size; ++i) {
+        hash ^= (unsigned char) name[i];
+        hash *= UINT64_C(1099511628211);
+    }
+    return hash;
+}
+
+const LibjSymbol *string_symbol(const LibjString *string) {
+    return (const LibjSymbol *) (string->value - offsetof(LibjSymbol, name));
+}
+
+uint64_t string_hash(const LibjString *string) {
+    if (LIBJ_STRING_INTERNED == string->storage) {
+        return string_symbol(string)->hash;
+    }
+    return name_hash(string->value, string->size);
+}
+
+/* Slot of name or the empty slot where it belongs. */
+static LibjSymbol **find_slot(LibjSymbolTable *table, uint64_t hash, const char *name, size_t name_size) {
+    size_t mask = table->slot_count - 1;
+    for (size_t i = hash & mask;; i = (i + 1) & mask) {
+        LibjSymbol *symbol = table->slots[i];
+        if (!symbol) {
+            return &table->slots[i];
+        }
+        if (symbol->hash == hash && symbol->size == name_size && !memcmp(symbol->name, name, name_size)) {
+            return &table->slots[i];
+        }
+    }
+}
+
+static LibjError table_create(Libj *libj, LibjSymbolTable **table) {
+    LibjError err = LIBJ_ERROR_OK;
+    LibjSymbolTable *result = NULL;
+    if (!libj || !table) {
+        err = LIBJ_ERROR_BAD_ARGUMENT;
+        goto end;
+    }
+    result = malloc(sizeof(LibjSymbolTable));
+    if (!result) {
+        err = LIBJ_ERROR_OUT_OF_MEMORY;
+        goto end;
+    }
+    result->storage = NULL;
+    result->slot_count = SYMBOL_TABLE_MIN_SLOTS;
+    result->used_slots = 0;
+    result->slots = calloc(result->slot_count, sizeof(LibjSymbol *));
+    if (!result->slots) {
+        err = LIBJ_ERROR_OUT_OF_MEMORY;
+        goto end;
+    }
+    err = E(libj_document_create(libj, &result->storage));
+    if (err) goto end;
+    *table = result;
+    result = NULL;
+end:
+    symbol_table_free(libj, &result);
+    return err;
+}
+
+/* Double the number of slots. */
+static LibjError table_grow(LibjSymbolTable *table) {
+    LibjError err = LIBJ_ERROR_OK;
+    size_t slot_count = 2 * table->slot_count;
+    LibjSymbol **slots = NULL;
+    if (SIZE_MAX / sizeof(LibjSymbol *) < slot_count) {
+        err = LIBJ_ERROR_OUT_OF_MEMORY;
+        goto end;
+    }
+    slots = calloc(slot_count, sizeof(LibjSymbol *));
+    if (!slots) {
+        err = LIBJ_ERROR_OUT_OF_MEMORY;
+        goto end;
+    }
+    LibjSymbol **old_slots = table->slots;
+    size_t old_slot_count = table->slot_count;
+    table->slots = slots;
+    table->slot_count = slot_count;
+    slots = old_slots;
+    for (size_t i = 0; i < old_slot_count; ++i) {
+        LibjSymbol *symbol = old_slots[i];
+        if (symbol) {
+            *find_slot(table, symbol->hash, symbol->name, symbol->size) = symbol;
+        }
+    }
+end:
+    free(slots);
+    return err;
+}
+
+void symbol_table_free(Libj *libj, LibjSymbolTable **symbols) {
+    if (!*symbols) {
+        return;
+    }
+    E(libj_document_free(libj, &(*symbols)->storage));
+    free((*symbols)->slots);
+    free(*symbols);
+    *symbols = NULL;
+}
+
+LibjError libj_use_interning(Libj *libj, bool enable) {
+    LibjError err = LIBJ_ERROR_OK;
+    if (!libj) {
+        err = LIBJ_ERROR_BAD_ARGUMENT;
+        goto end;
+    }
+    libj->interning = enable;
+end:
+    return err;
+}
+
+/* Find or add name to the symbol table of libj. When bounded and the table is full already a name that isn't in it
+ * yet is not added and *symbol is set to NULL. */
+static LibjError intern(Libj *libj, const char *name, size_t name_size, bool bounded, const LibjSymbol **symbol) {
+    LibjError err = LIBJ_ERROR_OK;
+    if (!libj || !name || !symbol) {
+        err = LIBJ_ERROR_BAD_ARGUMENT;
+        goto end;
+    }
+    if (!libj->symbols) {
+        err = E(table_create(libj, &libj->symbols));
+        if (err) goto end;
+    }
+    LibjSymbolTable *table = libj->symbols;
+    uint64_t hash = name_hash(name, name_size);
+    LibjSymbol **slot = find_slot(table, hash, name, name_size);
+    if (*slot) {
+        *symbol = *slot;
+        goto end;
+    }
+    if (bounded && SYMBOL_TABLE_MAX_IMPLICIT <= table->used_slots) {
+        *symbol = NULL;
+        goto end;
+    }
+    /* Keep at most half of the slots used. */
+    if (table->slot_count < 2 * (table->used_slots + 1)) {
+        err = E(table_grow(table));
+        if (err) goto end;
+        slot = find_slot(table, hash, name, name_size);
+    }
+    if (SIZE_MAX - sizeof(LibjSymbol) - 1 < name_size) {
+        err = LIBJ_ERROR_OUT_OF_MEMORY;
+        goto end;
+    }
+    LibjSymbol *result = libj_allocate(table->storage, sizeof(LibjSymbol) + name_size + 1);
+    if (!result) {
+        err = LIBJ_ERROR_OUT_OF_MEMORY;
+        goto end;
+    }
+    result->table = table;
+    result->hash = hash;
+    result->size = name_size;
+    memcpy(result->name, name, name_size);
+    result->name[name_size] = '\0';
+    *slot = result;
+    ++table->used_slots;
+    *symbol = result;
+end:
+    return err;
+}
+
+LibjError libj_intern(Libj *libj, const char *name, size_t name_size, const LibjSymbol **symbol) {
+    return intern(libj, name, name_size, false, symbol);
+}
+
+LibjError string_intern(Libj *libj, const char *value, size_t size, LibjString *string) {
+    LibjError err = LIBJ_ERROR_OK;
+    const LibjSymbol *symbol = NULL;
+    if (!libj || !value || !string) {
+        err = LIBJ_ERROR_BAD_ARGUMENT;
+        goto end;
+    }
+    err = E(intern(libj, value, size, true, &symbol));
+    if (err) goto end;
+    if (!symbol) {
+        goto end;
+    }
+    string->size = symbol->size;
+    string->value = (char *) symbol->name;
+    string->storage = LIBJ_STRING_INTERNED;
+end:
+    return err;
+}
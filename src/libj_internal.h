@@ -1,53 +1,132 @@
 #ifndef LIBJ_INTERNAL_H
 #define LIBJ_INTERNAL_H
 
+#include "libj_dtoa.h"
+
 #include <libj.h>
 #include <libsb.h>
 #include <libgb.h>
 #include <libis.h>
 #include <locale.h>
+#include <stdint.h>
+
+typedef struct LibjSymbolTable_ LibjSymbolTable;
+
+/* Bytes of the string or number being parsed. One scratch is reused for all values of a parse so that values
+ * stop costing allocations once it's big enough. */
+typedef struct {
+    char *bytes;
+    size_t size;
+    size_t capacity;
+} LibjScratch;
 
 struct Libj_ {
     Libsb *libsb;
     Libgb *libgb;
     Libis *libis;
     locale_t c_locale;
-    LibjToStringOptions *to_string_options;
-    LibsbBuilder *builder;
     int depth;
     char *error_string;
+    LibjDocument *document; /* Document that new json values are allocated from. NULL means the heap. */
+    LibjSymbolTable *symbols; /* NULL until something is interned */
+    bool interning; /* whether member names are interned */
+    bool typed_numbers; /* whether parsed numbers keep values instead of text when they can */
+    LibjScratch scratch; /* kept between NDJSON records so that reading them stops allocating */
+    char number_text[LIBJ_DOUBLE_BUFFER_SIZE + 1]; /* text of the last number without text libj_get_number() saw */
+};
+
+struct LibjSymbol_ {
+    LibjSymbolTable *table;
+    uint64_t hash;
+    size_t size;
+    char name[]; /* null-terminated */
 };
 
+typedef enum {
+    LIBJ_STRING_OWNED,  /* value is allocated from the document of json */
+    LIBJ_STRING_INSITU, /* value points into a buffer parsed in-situ which the caller keeps alive */
+    LIBJ_STRING_VIEW,   /* value points into a read-only buffer which the caller keeps alive, no null-terminator */
+    LIBJ_STRING_INTERNED, /* value is the name of a LibjSymbol which lives as long as its symbol table */
+} LibjStringStorage;
+
 typedef struct {
     size_t size;
-    char *value;
+    char *value; /* null-terminated unless storage is LIBJ_STRING_VIEW */
+    LibjStringStorage storage;
 } LibjString;
 
+/* Flags of LibjNumber::decoded. */
+enum {
+    LIBJ_NUMBER_INTEGER_DECODED = 1, /* integer holds the value */
+    LIBJ_NUMBER_INTEGER_EXACT = 2,   /* text is an integer that fits into integer */
+    LIBJ_NUMBER_REAL_DECODED = 4,    /* real holds the value */
+    LIBJ_NUMBER_REAL_EXACT = 8,      /* text is within the range of double */
+    LIBJ_NUMBER_REAL_VALUE = 16,     /* number without text is real rather than integer */
+};
+
+/* Number is kept as text which is what json holds. Values converted from the text are kept along with it, both
+ * of them are filled in by number_decode() when the number is created. A number parsed in typed mode may have no
+ * text at all (text.value == NULL). Its value is real if LIBJ_NUMBER_REAL_VALUE is set and integer otherwise, and
+ * text is made from it when it's needed. */
+typedef struct {
+    LibjString text;
+    unsigned decoded;
+    int64_t integer;
+    double real;
+} LibjNumber;
+
+/* Convert text of number into the values that aren't known yet. Numbers are converted when they are created, so
+ * that getters only read them. text is NULL for a number without text. */
+LibjError number_decode(Libj *libj, LibjNumber *number, const char *text, size_t text_size);
+
 typedef struct {
     LibjString name;
     LibjJson *value;
 } LibjMember;
 
+typedef struct LibjObjectIndex_ LibjObjectIndex;
+
 typedef struct {
     size_t size;
+    size_t capacity;
     LibjMember *members;
+    LibjObjectIndex *index; /* lookup table by name, NULL until object is big enough and looked up */
 } LibjObject;
 
 typedef struct {
     size_t size;
+    size_t capacity;
     LibjJson **elements;
 } LibjArray;
 
 struct LibjJson_ {
     LibjType type;
+    /* Document that json and everything it owns is allocated from. NULL means the heap. All values of a tree
+     * share the document of its root. */
+    LibjDocument *document;
     union {
         LibjObject object;
         LibjArray array;
         LibjString string;
+        LibjNumber number;
         bool boolean;
     };
 };
 
+/* Nesting levels of arrays and objects that the parser accepts. */
+#define LIBJ_MAX_DEPTH 100
+
+/* Bytes that the parser reads. It either wraps LibisInputStream or, when the whole input is in memory, walks
+ * the buffer directly. */
+typedef struct {
+    LibisInputStream *stream; /* NULL when input is a buffer */
+    const char *current;
+    const char *end;
+    LibjStringStorage strings; /* how parsed strings are stored, LIBJ_STRING_INSITU requires a mutable buffer */
+    size_t position; /* bytes of stream consumed so far */
+    bool lines; /* whitespace stops at newlines, so that a value can't continue past the end of its line */
+} LibjInput;
+
 #define ESB libsberror_to_libjerror
 
 LibjError libsberror_to_libjerror(LibsbError err);
@@ -64,23 +143,156 @@ LibjError libgberror_to_libjerror(LibgbError err);
 
 LibjError libj_handle_internal_error(LibjError err);
 
-LibjError libj_parse_value(Libj *libj, LibjJson **json, LibisInputStream *input);
+/* Allocate memory from document or from the heap when document is NULL. Return NULL on failure. */
+void *libj_allocate(LibjDocument *document, size_t size);
+
+/* Resize memory allocated with libj_allocate(). size is the current size of the memory. */
+void *libj_reallocate(LibjDocument *document, void *memory, size_t size, size_t new_size);
+
+/* Get the number of bytes document has taken from the heap so far. */
+size_t libj_document_size(LibjDocument *document);
+
+/* Release memory allocated with libj_allocate(). Memory of a document is released only with the document. */
+void libj_deallocate(LibjDocument *document, void *memory);
+
+/* Release value of string unless it is borrowed from somewhere else. */
+void string_release(LibjDocument *document, LibjString *string);
 
-LibjError libj_parse_value_object(Libj *libj, LibjJson **json, LibisInputStream *input);
+/* Replace view with an owned null-terminated copy allocated from document. Other strings are left as they are. */
+LibjError string_materialize(Libj *libj, LibjDocument *document, LibjString *string);
 
-LibjError libj_parse_value_array(Libj *libj, LibjJson **json, LibisInputStream *input);
+/* Write text made from value of number that has no text into buffer of LIBJ_DOUBLE_BUFFER_SIZE bytes. Returns
+ * the number of bytes written. */
+size_t number_format(const LibjNumber *number, char *buffer);
 
-LibjError libj_parse_value_true(Libj *libj, LibjJson **json, LibisInputStream *input);
+/* Hash of a member name. */
+uint64_t name_hash(const char *name, size_t name_size);
 
-LibjError libj_parse_value_false(Libj *libj, LibjJson **json, LibisInputStream *input);
+/* Symbol whose name is value of an interned string. */
+const LibjSymbol *string_symbol(const LibjString *string);
 
-LibjError libj_parse_value_null(Libj *libj, LibjJson **json, LibisInputStream *input);
+/* Same as name_hash() of string but without going over the bytes of interned strings. */
+uint64_t string_hash(const LibjString *string);
+
+/* Make string the interned copy of value. The symbol table owns the bytes so string is never released. string is
+ * left as it is when the symbol table is too big to take a new name. */
+LibjError string_intern(Libj *libj, const char *value, size_t size, LibjString *string);
+
+/* Release symbol table together with all the symbols in it. *symbols == NULL is allowed. */
+void symbol_table_free(Libj *libj, LibjSymbolTable **symbols);
+
+/* Create json of type with empty content allocated from document. */
+LibjError json_create(Libj *libj, LibjDocument *document, LibjType type, LibjJson **json);
+
+/* Create a deep copy of source allocated from document. */
+LibjError json_copy(Libj *libj, LibjDocument *document, LibjJson *source, LibjJson **target);
+
+/* Append size bytes to scratch growing it as needed. */
+LibjError scratch_append(LibjScratch *scratch, const char *bytes, size_t size);
+
+/* State of a parse that reports json to handler as it's found. */
+typedef struct {
+    Libj *libj;
+    LibjInput *input;
+    const LibjHandler *handler;
+    void *user;
+    LibjScratch scratch;
+    bool in_input; /* whether the last string or number passed to handler points into buffer input */
+    int64_t integer; /* integer and decoded of the last number as LibjNumber keeps them */
+    unsigned decoded;
+} LibjParser;
 
-LibjError libj_parse_value_string(Libj *libj, LibjJson **json, LibisInputStream *input);
+/* Set up parser to read input and report to handler. Scratch of parser starts empty. */
+void parser_init(LibjParser *parser, Libj *libj, LibjInput *input, const LibjHandler *handler, void *user);
+
+/* Replace error string of libj with a formatted one. */
+LibjError errorf(Libj *libj, const char *format, ...);
+
+/* Skip whitespace and then literal which must follow. */
+LibjError libj_skip_literal(Libj *libj, LibjInput *input, const char *literal);
+
+/* Skip UTF-8 byte order mark if input starts with one. */
+LibjError libj_skip_bom(Libj *libj, LibjInput *input);
+
+/* Parse member name and pass it to on_key. */
+LibjError libj_parse_key(LibjParser *parser);
+
+LibjError libj_parse_value(LibjParser *parser);
+
+LibjError libj_parse_value_object(LibjParser *parser);
+
+LibjError libj_parse_value_array(LibjParser *parser);
+
+LibjError libj_parse_value_true(LibjParser *parser);
+
+LibjError libj_parse_value_false(LibjParser *parser);
+
+LibjError libj_parse_value_null(LibjParser *parser);
+
+LibjError libj_parse_value_string(LibjParser *parser);
+
+LibjError libj_parse_value_number(LibjParser *parser);
 
 LibjError object_get_version_index_ex(
-        LibjJson *json, const char *name, size_t name_size, int version, size_t *index);
+        LibjJson *json, const char *name, size_t name_size, size_t version, size_t *index);
 
+/* Number of members of object json named name. */
+size_t object_count_versions(LibjJson *json, const char *name, size_t name_size);
 
-#endif
+/* Find index of member of object json which is given version of name. Returns false if there's no such member. */
+bool object_find_version(LibjJson *json, const char *name, size_t name_size, size_t version, size_t *index);
+
+/* Find index of the latest version of name. Returns false if there's no member named name. */
+bool object_find_last_version(LibjJson *json, const char *name, size_t name_size, size_t *index);
 
+/* Find index of the latest version of member named symbol. Returns false if there's no such member. */
+bool object_find_last_symbol(LibjJson *json, const LibjSymbol *symbol, size_t *index);
+
+/* Remove every member of object json named name in a single pass except the one at *keep which is updated to its
+ * new position. keep may be NULL to remove all of them. */
+LibjError object_remove_versions(Libj *libj, LibjJson *json, const char *name, size_t name_size, size_t *keep);
+
+/* Make *value the only member of object json named name. It takes the place of the latest version of name or is
+ * appended if there's none. *value is taken over by json and reset on success. */
+LibjError object_set_take(Libj *libj, LibjJson *json, const char *name, size_t name_size, LibjJson **value);
+
+/* Update lookup table of object json after a member was appended to it. */
+void object_index_appended(LibjJson *json);
+
+/* Update lookup table of object json before member i is removed from it. */
+void object_index_removed(LibjJson *json, size_t i);
+
+/* Release lookup table of object json. */
+void object_index_free(LibjJson *json);
+
+/* Mark lookup table of object json stale. Must be called whenever members are moved or inserted in the middle or
+ * removed other than with object_index_removed(). */
+void object_index_invalidate(LibjJson *json);
+
+/* Insert new member before specified position. Both name->value and *value are taken over by json and
+ * reset on success. On failure the caller keeps ownership of them. name->value must be allocated from the
+ * document of json. */
+LibjError object_insert_at_take(Libj *libj, LibjJson *json, size_t position, LibjString *name, LibjJson **value);
+
+/* Json values made of parse events. Containers are added to their parents as soon as they start, so everything
+ * built so far hangs off root and is released with it. */
+typedef struct {
+    Libj *libj;
+    LibjParser *parser;
+    LibjError err; /* what made a callback stop parsing */
+    LibjJson *root;
+    size_t depth;
+    LibjJson *containers[LIBJ_MAX_DEPTH + 1]; /* containers that haven't ended yet, innermost last */
+    LibjString name; /* name of the member whose value comes next */
+} LibjBuilder;
+
+/* Callbacks that build json out of parse events. user of the parser must be a LibjBuilder. */
+extern const LibjHandler builder_handler;
+
+/* Set up builder of json that parser reports. */
+void builder_init(LibjBuilder *builder, Libj *libj, LibjParser *parser);
+
+/* Release whatever builder has built and not given away. */
+void builder_free(LibjBuilder *builder);
+
+#endif
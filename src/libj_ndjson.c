@@ -0,0 +1,536 @@
+#include "libj_internal.h"
+#include "libj_utils.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/* Input is handed out to workers in pieces of about this many bytes, extended to the end of the last line. Small
+ * pieces let the callback get records while they are still in cache. */
+#define PIECE_SIZE (1 << 16)
+
+/* Skip blanks after a record and the newline that ends it. The last record may end with input instead. */
+static LibjError skip_record_end(Libj *libj, LibjInput *input) {
+    LibjError err = LIBJ_ERROR_OK;
+    char c;
+    bool eof;
+    if (!libj || !input) {
+        err = LIBJ_ERROR_BAD_ARGUMENT;
+        goto end;
+    }
+    err = libj_input_lookahead(libj, input, &eof, &c);
+    if (err) goto end;
+    while (!eof && (' ' == c || '\t' == c || '\r' == c)) {
+        err = libj_input_skip_char(libj, input, &eof, &c);
+        if (err) goto end;
+    }
+    if (eof) {
+        goto end;
+    }
+    if ('\n' != c) {
+        E(errorf(libj, "newline was expected", 0));
+        err = LIBJ_ERROR_SYNTAX;
+        goto end;
+    }
+    err = libj_input_skip_char(libj, input, &eof, &c);
+    if (err) goto end;
+end:
+    return err;
+}
+
+/* Parse one value from input into *json and skip what ends its line. */
+static LibjError parse_record(Libj *libj, LibjInput *input, LibjJson **json) {
+    LibjError err = LIBJ_ERROR_OK;
+    LibjParser parser;
+    LibjBuilder builder;
+    builder_init(&builder, libj, &parser);
+    if (!libj || !input || !json) {
+        err = LIBJ_ERROR_BAD_ARGUMENT;
+        goto end;
+    }
+    /* Scratch of the context is lent to the parser so that its capacity carries over to the next record. */
+    parser_init(&parser, libj, input, &builder_handler, &builder);
+    parser.scratch = libj->scratch;
+    libj->depth = 0;
+    err = E(libj_parse_value(&parser));
+    libj->scratch = parser.scratch;
+    libj->scratch.size = 0;
+    /* Callbacks of the builder stop parsing only because of their own errors. */
+    if (LIBJ_ERROR_STOPPED == err) {
+        err = builder.err;
+    }
+    if (err) goto end;
+    err = E(skip_record_end(libj, input));
+    if (err) goto end;
+    *json = builder.root;
+    builder.root = NULL;
+end:
+    builder_free(&builder);
+    return err;
+}
+
+/* Parse the record that input is at into *json. *json is left NULL if nothing but whitespace is left. A record
+ * ends with its line, so a value that continues on the next line is a syntax error. */
+static LibjError read_record(Libj *libj, LibjInput *input, LibjJson **json) {
+    LibjError err = LIBJ_ERROR_OK;
+    char c;
+    bool eof;
+    if (!libj || !input || !json) {
+        err = LIBJ_ERROR_BAD_ARGUMENT;
+        goto end;
+    }
+    *json = NULL;
+    err = libj_skip_whitespace(libj, input, &eof, &c);
+    if (err || eof) goto end;
+    if (input->stream) {
+        input->lines = true;
+        err = E(parse_record(libj, input, json));
+        input->lines = false;
+        goto end;
+    }
+    /* In a buffer the value is parsed in place with input cut at the end of its line. */
+    const char *newline = memchr(input->current, '\n', input->end - input->current);
+    LibjInput line = *input;
+    if (newline) {
+        line.end = newline;
+    }
+    err = E(parse_record(libj, &line, json));
+    if (err) goto end;
+    input->current = newline ? newline + 1 : input->end;
+end:
+    return err;
+}
+
+/* Prefix the error message of libj with the byte where the bad record starts. Errors without a message are
+ * described by the error table. */
+static void locate_error(Libj *libj, LibjError err, size_t offset) {
+    char *error_string = libj->error_string;
+    libj->error_string = NULL;
+    E(errorf(libj, "record at byte %zu: %s", offset,
+             error_string ? error_string : libj_error_to_human_readable_string(err)));
+    free(error_string);
+}
+
+LibjError libj_ndjson_next(Libj *libj, LibisInputStream *input, size_t *offset, LibjJson **json,
+                           const char **error_string) {
+    LibjError err = LIBJ_ERROR_OK;
+    LibjInput stream_input;
+    char c;
+    bool eof;
+    if (!libj || !input || !offset || !json || !error_string) {
+        err = LIBJ_ERROR_BAD_ARGUMENT;
+        goto end;
+    }
+    free(libj->error_string);
+    libj->error_string = NULL;
+    *json = NULL;
+    libj_input_from_stream(&stream_input, input);
+    err = libj_skip_whitespace(libj, &stream_input, &eof, &c);
+    size_t record_offset = *offset + stream_input.position;
+    if (!err && !eof) {
+        err = E(read_record(libj, &stream_input, json));
+    }
+    if (err) locate_error(libj, err, record_offset);
+    *offset += stream_input.position;
+    *error_string = err ? libj->error_string : "";
+end:
+    return err;
+}
+
+/* Where a piece of input is in its way from a worker to the callback. */
+typedef enum {
+    SLOT_FREE,
+    SLOT_BUSY, /* a worker parses it */
+    SLOT_DONE, /* its records wait to be passed to the callback */
+} SlotState;
+
+/* Records of one piece of input. */
+typedef struct {
+    SlotState state;
+    size_t piece; /* index of the piece in input */
+    LibjJson **records;
+    size_t *offsets; /* where each record starts in input */
+    size_t size;
+    size_t capacity;
+    LibjError err; /* what stopped the worker before the end of the piece */
+    size_t error_offset;
+    char *error_string; /* NULL if the worker had no message for err */
+} Slot;
+
+/* State shared by the workers and the thread that passes records to the callback. Pieces are parsed only while
+ * a slot is free for them, so at most slot_count pieces are held in memory however slow the callback is. */
+typedef struct {
+    const char *buffer;
+    size_t buffer_size;
+    bool ordered;
+    pthread_mutex_t mutex;
+    pthread_cond_t slot_freed;
+    pthread_cond_t slot_done;
+    size_t next_offset; /* where the next piece starts */
+    size_t next_piece;
+    size_t next_delivery; /* index of the piece whose records come next in input order */
+    bool stop;
+    size_t slot_count;
+    Slot *slots;
+} Ingestion;
+
+/* Each worker has a context of its own since contexts keep per-call state. */
+typedef struct {
+    Ingestion *ingestion;
+    Libj *libj;
+    pthread_t thread;
+    bool started;
+} Worker;
+
+static void slot_clear(Libj *libj, Slot *slot) {
+    for (size_t i = 0; i < slot->size; ++i) {
+        E(libj_free_json(libj, &slot->records[i]));
+    }
+    slot->size = 0;
+    slot->err = LIBJ_ERROR_OK;
+    free(slot->error_string);
+    slot->error_string = NULL;
+}
+
+static LibjError slot_add(Slot *slot, LibjJson **json, size_t offset) {
+    LibjError err = LIBJ_ERROR_OK;
+    if (!slot || !json) {
+        err = LIBJ_ERROR_BAD_ARGUMENT;
+        goto end;
+    }
+    if (slot->size == slot->capacity) {
+        size_t capacity = slot->capacity ? 2 * slot->capacity : 256;
+        if (SIZE_MAX / sizeof(size_t) < capacity) {
+            err = LIBJ_ERROR_OUT_OF_MEMORY;
+            goto end;
+        }
+        LibjJson **records = realloc(slot->records, capacity * sizeof(LibjJson *));
+        if (!records) {
+            err = LIBJ_ERROR_OUT_OF_MEMORY;
+            goto end;
+        }
+        slot->records = records;
+        size_t *offsets = realloc(slot->offsets, capacity * sizeof(size_t));
+        if (!offsets) {
+            err = LIBJ_ERROR_OUT_OF_MEMORY;
+            goto end;
+        }
+        slot->offsets = offsets;
+        slot->capacity = capacity;
+    }
+    slot->records[slot->size] = *json;
+    slot->offsets[slot->size] = offset;
+    ++slot->size;
+    *json = NULL;
+end:
+    return err;
+}
+
+/* Parse records of input[begin, end) into slot. The first bad record ends the piece. */
+static void parse_piece(Worker *worker, Slot *slot, size_t begin, size_t end) {
+    Libj *libj = worker->libj;
+    const char *buffer = worker->ingestion->buffer;
+    LibjInput input;
+    libj_input_from_buffer(&input, buffer + begin, end - begin);
+    free(libj->error_string);
+    libj->error_string = NULL;
+    for (;;) {
+        LibjJson *json = NULL;
+        char c;
+        bool eof;
+        LibjError err = libj_skip_whitespace(libj, &input, &eof, &c);
+        size_t offset = input.current - buffer;
+        if (!err && eof) {
+            break;
+        }
+        if (!err) {
+            err = E(read_record(libj, &input, &json));
+        }
+        if (!err) {
+            err = E(slot_add(slot, &json, offset));
+        }
+        E(libj_free_json(libj, &json));
+        if (err) {
+            slot->err = err;
+            slot->error_offset = offset;
+            if (libj->error_string) {
+                slot->error_string = strdup(libj->error_string);
+            }
+            break;
+        }
+    }
+}
+
+/* Slot that the next piece may be parsed into or NULL if it has to wait. */
+static Slot *free_slot(Ingestion *ingestion) {
+    if (ingestion->ordered) {
+        Slot *slot = &ingestion->slots[ingestion->next_piece % ingestion->slot_count];
+        return SLOT_FREE == slot->state ? slot : NULL;
+    }
+    for (size_t i = 0; i < ingestion->slot_count; ++i) {
+        if (SLOT_FREE == ingestion->slots[i].state) {
+            return &ingestion->slots[i];
+        }
+    }
+    return NULL;
+}
+
+/* Slot whose records may be passed to the callback now or NULL if there's none yet. */
+static Slot *done_slot(Ingestion *ingestion) {
+    if (ingestion->ordered) {
+        Slot *slot = &ingestion->slots[ingestion->next_delivery % ingestion->slot_count];
+        return SLOT_DONE == slot->state && slot->piece == ingestion->next_delivery ? slot : NULL;
+    }
+    for (size_t i = 0; i < ingestion->slot_count; ++i) {
+        if (SLOT_DONE == ingestion->slots[i].state) {
+            return &ingestion->slots[i];
+        }
+    }
+    return NULL;
+}
+
+/* Whether all of input has been parsed and passed on. */
+static bool is_finished(Ingestion *ingestion) {
+    if (ingestion->next_offset != ingestion->buffer_size) {
+        return false;
+    }
+    for (size_t i = 0; i < ingestion->slot_count; ++i) {
+        if (SLOT_FREE != ingestion->slots[i].state) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void *work(void *user) {
+    Worker *worker = user;
+    Ingestion *ingestion = worker->ingestion;
+    pthread_mutex_lock(&ingestion->mutex);
+    for (;;) {
+        Slot *slot = NULL;
+        while (!ingestion->stop && ingestion->next_offset != ingestion->buffer_size
+                && !(slot = free_slot(ingestion))) {
+            pthread_cond_wait(&ingestion->slot_freed, &ingestion->mutex);
+        }
+        if (!slot) {
+            break;
+        }
+        /* Records end with their lines, so a piece that ends right after a newline splits none of them. */
+        size_t begin = ingestion->next_offset;
+        size_t end = ingestion->buffer_size;
+        if (PIECE_SIZE < end - begin) {
+            const char *newline = memchr(ingestion->buffer + begin + PIECE_SIZE, '\n',
+                                         end - begin - PIECE_SIZE);
+            if (newline) {
+                end = newline + 1 - ingestion->buffer;
+            }
+        }
+        slot->state = SLOT_BUSY;
+        slot->piece = ingestion->next_piece++;
+        ingestion->next_offset = end;
+        pthread_mutex_unlock(&ingestion->mutex);
+        parse_piece(worker, slot, begin, end);
+        pthread_mutex_lock(&ingestion->mutex);
+        slot->state = SLOT_DONE;
+        pthread_cond_broadcast(&ingestion->slot_done);
+    }
+    pthread_mutex_unlock(&ingestion->mutex);
+    return NULL;
+}
+
+/* Pass records of slot to the callback. Records it doesn't get are released. */
+static LibjError deliver(Libj *libj, Slot *slot, LibjRecordCallback callback, void *user) {
+    LibjError err = LIBJ_ERROR_OK;
+    if (!libj || !slot || !callback) {
+        err = LIBJ_ERROR_BAD_ARGUMENT;
+        goto end;
+    }
+    for (size_t i = 0; i < slot->size; ++i) {
+        LibjJson *json = slot->records[i];
+        slot->records[i] = NULL;
+        if (!callback(user, json, slot->offsets[i])) {
+            err = LIBJ_ERROR_STOPPED;
+            goto end;
+        }
+    }
+    err = slot->err;
+    if (err) {
+        const char *error_string = slot->error_string ? slot->error_string : libj_error_to_human_readable_string(err);
+        E(errorf(libj, "record at byte %zu: %s", slot->error_offset, error_string));
+    }
+end:
+    if (slot) slot_clear(libj, slot);
+    return err;
+}
+
+/* Pass records to the callback as workers get them ready until input is over or something fails. */
+static LibjError deliver_all(Libj *libj, Ingestion *ingestion, LibjRecordCallback callback, void *user) {
+    LibjError err = LIBJ_ERROR_OK;
+    pthread_mutex_lock(&ingestion->mutex);
+    for (;;) {
+        Slot *slot = NULL;
+        while (!(slot = done_slot(ingestion)) && !is_finished(ingestion)) {
+            pthread_cond_wait(&ingestion->slot_done, &ingestion->mutex);
+        }
+        if (!slot) {
+            break;
+        }
+        pthread_mutex_unlock(&ingestion->mutex);
+        err = E(deliver(libj, slot, callback, user));
+        pthread_mutex_lock(&ingestion->mutex);
+        slot->state = SLOT_FREE;
+        ++ingestion->next_delivery;
+        if (err) {
+            break;
+        }
+        pthread_cond_broadcast(&ingestion->slot_freed);
+    }
+    ingestion->stop = true;
+    pthread_cond_broadcast(&ingestion->slot_freed);
+    pthread_mutex_unlock(&ingestion->mutex);
+    return err;
+}
+
+LibjError libj_ndjson_parse_parallel(Libj *libj, const char *buffer, size_t buffer_size, size_t threads,
+                                     bool ordered, LibjRecordCallback callback, void *user,
+                                     const char **error_string) {
+    LibjError err = LIBJ_ERROR_OK;
+    Ingestion ingestion = { .buffer = buffer, .buffer_size = buffer_size, .ordered = ordered };
+    Worker *workers = NULL;
+    bool synchronized = false;
+    if (!libj || !buffer || !callback || !error_string) {
+        err = LIBJ_ERROR_BAD_ARGUMENT;
+        goto end;
+    }
+    free(libj->error_string);
+    libj->error_string = NULL;
+    if (!threads) {
+        long processors = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = 0 < processors ? (size_t) processors : 1;
+    }
+    if (SIZE_MAX / 2 / sizeof(Slot) < threads) {
+        err = LIBJ_ERROR_OUT_OF_MEMORY;
+        goto done;
+    }
+    /* Twice as many slots as workers let them go on while the callback is busy with earlier pieces. */
+    ingestion.slot_count = 2 * threads;
+    ingestion.slots = calloc(ingestion.slot_count, sizeof(Slot));
+    workers = calloc(threads, sizeof(Worker));
+    if (!ingestion.slots || !workers) {
+        err = LIBJ_ERROR_OUT_OF_MEMORY;
+        goto done;
+    }
+    if (pthread_mutex_init(&ingestion.mutex, NULL)) {
+        err = LIBJ_ERROR_OUT_OF_MEMORY;
+        goto done;
+    }
+    if (pthread_cond_init(&ingestion.slot_freed, NULL)) {
+        pthread_mutex_destroy(&ingestion.mutex);
+        err = LIBJ_ERROR_OUT_OF_MEMORY;
+        goto done;
+    }
+    if (pthread_cond_init(&ingestion.slot_done, NULL)) {
+        pthread_cond_destroy(&ingestion.slot_freed);
+        pthread_mutex_destroy(&ingestion.mutex);
+        err = LIBJ_ERROR_OUT_OF_MEMORY;
+        goto done;
+    }
+    synchronized = true;
+    /* Interned names would outlive the symbol tables of workers, so records of workers aren't interned. */
+    for (size_t i = 0; i < threads; ++i) {
+        workers[i].ingestion = &ingestion;
+        err = E(libj_start(&workers[i].libj));
+        if (err) goto done;
+        err = E(libj_use_typed_numbers(workers[i].libj, libj->typed_numbers));
+        if (err) goto done;
+    }
+    for (size_t i = 0; i < threads; ++i) {
+        if (pthread_create(&workers[i].thread, NULL, work, &workers[i])) {
+            /* Workers that have started are enough to get through input. */
+            if (!i) {
+                err = LIBJ_ERROR_OUT_OF_MEMORY;
+                goto done;
+            }
+            break;
+        }
+        workers[i].started = true;
+    }
+    err = E(deliver_all(libj, &ingestion, callback, user));
+done:
+    if (synchronized) {
+        pthread_mutex_lock(&ingestion.mutex);
+        ingestion.stop = true;
+        pthread_cond_broadcast(&ingestion.slot_freed);
+        pthread_mutex_unlock(&ingestion.mutex);
+    }
+    for (size_t i = 0; workers && i < threads; ++i) {
+        if (workers[i].started) {
+            pthread_join(workers[i].thread, NULL);
+        }
+    }
+    for (size_t i = 0; ingestion.slots && i < ingestion.slot_count; ++i) {
+        slot_clear(libj, &ingestion.slots[i]);
+        free(ingestion.slots[i].records);
+        free(ingestion.slots[i].offsets);
+    }
+    for (size_t i = 0; workers && i < threads; ++i) {
+        E(libj_finish(&workers[i].libj));
+    }
+    if (synchronized) {
+        pthread_cond_destroy(&ingestion.slot_done);
+        pthread_cond_destroy(&ingestion.slot_freed);
+        pthread_mutex_destroy(&ingestion.mutex);
+    }
+    free(ingestion.slots);
+    free(workers);
+    /* Callback that stops parsing leaves no message. */
+    *error_string = !err ? "" : libj->error_string ? libj->error_string : libj_error_to_human_readable_string(err);
+end:
+    return err;
+}
+
+LibjError libj_ndjson_parse_file(Libj *libj, const char *path, size_t threads, bool ordered,
+                                 LibjRecordCallback callback, void *user, const char **error_string) {
+    LibjError err = LIBJ_ERROR_OK;
+    int fd = -1;
+    void *mapping = MAP_FAILED;
+    size_t size = 0;
+    struct stat status;
+    if (!libj || !path || !callback || !error_string) {
+        err = LIBJ_ERROR_BAD_ARGUMENT;
+        goto end;
+    }
+    fd = open(path, O_RDONLY);
+    if (fd < 0 || fstat(fd, &status)) {
+        err = LIBJ_ERROR_IO;
+        goto fail;
+    }
+    size = status.st_size;
+    /* Empty file can't be mapped but it has no records either. */
+    if (!size) {
+        err = E(libj_ndjson_parse_parallel(libj, "", 0, threads, ordered, callback, user, error_string));
+        goto end;
+    }
+    mapping = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (MAP_FAILED == mapping) {
+        err = LIBJ_ERROR_IO;
+        goto fail;
+    }
+    madvise(mapping, size, MADV_SEQUENTIAL);
+    err = E(libj_ndjson_parse_parallel(libj, mapping, size, threads, ordered, callback, user, error_string));
+    goto end;
+fail:
+    free(libj->error_string);
+    libj->error_string = NULL;
+    E(errorf(libj, "%s: %s", path, strerror(errno)));
+    *error_string = libj->error_string;
+end:
+    if (MAP_FAILED != mapping) munmap(mapping, size);
+    if (0 <= fd) close(fd);
+    return err;
+}
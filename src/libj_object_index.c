@@ -0,0 +1,325 @@
+#include "libj_internal.h"
+
+#include <stdint.h>
+#include <string.h>
+
+/* Objects with fewer members are searched linearly. */
+#define INDEX_THRESHOLD 16
+
+#define NO_MEMBER SIZE_MAX
+
+/* All versions of one name. */
+typedef struct {
+    uint64_t hash;
+    size_t first; /* index of the first version, NO_MEMBER for an empty slot */
+    size_t last;
+    size_t count;
+} IndexSlot;
+
+/* Hash table from member names to members. Versions of a name are chained through next in insertion order. The
+ * index is kept up to date while members are appended or removed. Any other change of the object marks it stale
+ * and it's built again in the same storage on the next lookup, so that documents don't grow with every change. */
+struct LibjObjectIndex_ {
+    bool stale;
+    size_t slot_count; /* power of two */
+    size_t used_slots;
+    IndexSlot *slots;
+    size_t next_capacity;
+    size_t *next; /* next[i] is the index of the version that follows member i */
+};
+
+static bool has_name(LibjMember *member, const char *name, size_t name_size) {
+    /* Interned names are equal when they are the same symbol. */
+    if (member->name.size != name_size) {
+        return false;
+    }
+    return member->name.value == name || !memcmp(member->name.value, name, name_size);
+}
+
+static bool has_symbol(LibjMember *member, const LibjSymbol *symbol) {
+    if (member->name.value == symbol->name) {
+        return true;
+    }
+    /* Distinct symbols of one table have distinct names. */
+    if (LIBJ_STRING_INTERNED == member->name.storage && string_symbol(&member->name)->table == symbol->table) {
+        return false;
+    }
+    return has_name(member, symbol->name, symbol->size);
+}
+
+/* Slot of name or the empty slot where it belongs. */
+static IndexSlot *find_slot(LibjJson *json, uint64_t hash, const char *name, size_t name_size) {
+    LibjObjectIndex *index = json->object.index;
+    size_t mask = index->slot_count - 1;
+    for (size_t i = hash & mask;; i = (i + 1) & mask) {
+        IndexSlot *slot = &index->slots[i];
+        if (NO_MEMBER == slot->first) {
+            return slot;
+        }
+        if (slot->hash == hash && has_name(&json->object.members[slot->first], name, name_size)) {
+            return slot;
+        }
+    }
+}
+
+/* Add member i which has to be the last one to the index. Room for it must have been made already. */
+static void index_add(LibjJson *json, size_t i) {
+    LibjObjectIndex *index = json->object.index;
+    LibjString name = json->object.members[i].name;
+    uint64_t hash = string_hash(&name);
+    IndexSlot *slot = find_slot(json, hash, name.value, name.size);
+    index->next[i] = NO_MEMBER;
+    if (NO_MEMBER == slot->first) {
+        slot->hash = hash;
+        slot->first = i;
+        slot->last = i;
+        slot->count = 1;
+        ++index->used_slots;
+    } else {
+        index->next[slot->last] = i;
+        slot->last = i;
+        ++slot->count;
+    }
+}
+
+static void index_free(LibjDocument *document, LibjObjectIndex *index) {
+    if (!index) {
+        return;
+    }
+    libj_deallocate(document, index->slots);
+    libj_deallocate(document, index->next);
+    libj_deallocate(document, index);
+}
+
+/* Build index of json unless it's too small to need one or it's up to date already. Storage of a stale index is
+ * reused when it's big enough. Index is left NULL when memory runs out. */
+static LibjObjectIndex *index_get(LibjJson *json) {
+    LibjObject *object = &json->object;
+    LibjObjectIndex *index = object->index;
+    if (index && !index->stale) {
+        return index;
+    }
+    if (object->size < INDEX_THRESHOLD) {
+        return NULL;
+    }
+    if (!index) {
+        index = libj_allocate(json->document, sizeof(LibjObjectIndex));
+        if (!index) {
+            return NULL;
+        }
+        index->slot_count = 0;
+        index->slots = NULL;
+        index->next_capacity = 0;
+        index->next = NULL;
+        object->index = index;
+    }
+    size_t slot_count = 4 * INDEX_THRESHOLD;
+    while (slot_count < 4 * object->size) {
+        slot_count *= 2;
+    }
+    if (index->slot_count < slot_count) {
+        IndexSlot *slots = NULL;
+        if (slot_count <= SIZE_MAX / sizeof(IndexSlot)) {
+            slots = libj_reallocate(json->document, index->slots,
+                                    index->slot_count * sizeof(IndexSlot), slot_count * sizeof(IndexSlot));
+        }
+        if (!slots) {
+            goto fail;
+        }
+        index->slots = slots;
+        index->slot_count = slot_count;
+    }
+    if (index->next_capacity < object->size) {
+        size_t next_capacity = 2 * object->size;
+        size_t *next = NULL;
+        if (next_capacity <= SIZE_MAX / sizeof(size_t)) {
+            next = libj_reallocate(json->document, index->next,
+                                   index->next_capacity * sizeof(size_t), next_capacity * sizeof(size_t));
+        }
+        if (!next) {
+            goto fail;
+        }
+        index->next = next;
+        index->next_capacity = next_capacity;
+    }
+    for (size_t i = 0; i < index->slot_count; ++i) {
+        index->slots[i].first = NO_MEMBER;
+        index->slots[i].count = 0;
+    }
+    index->used_slots = 0;
+    index->stale = false;
+    for (size_t i = 0; i < object->size; ++i) {
+        index_add(json, i);
+    }
+    return index;
+fail:
+    index_free(json->document, index);
+    object->index = NULL;
+    return NULL;
+}
+
+void object_index_free(LibjJson *json) {
+    index_free(json->document, json->object.index);
+    json->object.index = NULL;
+}
+
+void object_index_invalidate(LibjJson *json) {
+    if (json->object.index) {
+        json->object.index->stale = true;
+    }
+}
+
+void object_index_appended(LibjJson *json) {
+    LibjObjectIndex *index = json->object.index;
+    if (!index || index->stale) {
+        return;
+    }
+    /* Keep at most half of the slots used. Otherwise index is rebuilt bigger when it's needed next time. */
+    if (index->slot_count < 2 * (index->used_slots + 1)) {
+        index->stale = true;
+        return;
+    }
+    if (index->next_capacity < json->object.size) {
+        size_t next_capacity = 2 * index->next_capacity;
+        size_t *next = NULL;
+        if (next_capacity <= SIZE_MAX / sizeof(size_t)) {
+            next = libj_reallocate(json->document, index->next,
+                                   index->next_capacity * sizeof(size_t), next_capacity * sizeof(size_t));
+        }
+        if (!next) {
+            object_index_free(json);
+            return;
+        }
+        index->next = next;
+        index->next_capacity = next_capacity;
+    }
+    index_add(json, json->object.size - 1);
+}
+
+/* Empty slot and move back the slots after it that linear probing would no longer reach. */
+static void remove_slot(LibjObjectIndex *index, IndexSlot *slot) {
+    size_t mask = index->slot_count - 1;
+    size_t hole = slot - index->slots;
+    for (size_t i = (hole + 1) & mask; NO_MEMBER != index->slots[i].first; i = (i + 1) & mask) {
+        size_t home = index->slots[i].hash & mask;
+        /* Slot i may fill the hole unless it belongs between the hole and itself. */
+        if (((i - home) & mask) >= ((i - hole) & mask)) {
+            index->slots[hole] = index->slots[i];
+            hole = i;
+        }
+    }
+    index->slots[hole].first = NO_MEMBER;
+    index->slots[hole].count = 0;
+    --index->used_slots;
+}
+
+void object_index_removed(LibjJson *json, size_t i) {
+    LibjObjectIndex *index = json->object.index;
+    if (!index || index->stale) {
+        return;
+    }
+    LibjString name = json->object.members[i].name;
+    IndexSlot *slot = find_slot(json, string_hash(&name), name.value, name.size);
+    if (slot->first == i) {
+        slot->first = index->next[i];
+    } else {
+        size_t previous = slot->first;
+        while (index->next[previous] != i) {
+            previous = index->next[previous];
+        }
+        index->next[previous] = index->next[i];
+        if (slot->last == i) {
+            slot->last = previous;
+        }
+    }
+    if (!--slot->count) {
+        remove_slot(index, slot);
+    }
+    /* Members after i move one position down. */
+    for (size_t k = 0; k < index->slot_count; ++k) {
+        IndexSlot *moved = &index->slots[k];
+        if (NO_MEMBER != moved->first) {
+            moved->first -= i < moved->first;
+            moved->last -= i < moved->last;
+        }
+    }
+    size_t size = json->object.size;
+    memmove(&index->next[i], &index->next[i + 1], sizeof(size_t) * (size - i - 1));
+    for (size_t k = 0; k + 1 < size; ++k) {
+        if (NO_MEMBER != index->next[k] && i < index->next[k]) {
+            --index->next[k];
+        }
+    }
+}
+
+size_t object_count_versions(LibjJson *json, const char *name, size_t name_size) {
+    if (index_get(json)) {
+        return find_slot(json, name_hash(name, name_size), name, name_size)->count;
+    }
+    size_t count = 0;
+    for (size_t i = 0; i < json->object.size; ++i) {
+        if (has_name(&json->object.members[i], name, name_size)) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+bool object_find_version(LibjJson *json, const char *name, size_t name_size, size_t version, size_t *index) {
+    LibjObjectIndex *object_index = index_get(json);
+    if (object_index) {
+        IndexSlot *slot = find_slot(json, name_hash(name, name_size), name, name_size);
+        if (slot->count <= version) {
+            return false;
+        }
+        size_t i = slot->first;
+        while (version--) {
+            i = object_index->next[i];
+        }
+        *index = i;
+        return true;
+    }
+    for (size_t i = 0; i < json->object.size; ++i) {
+        if (has_name(&json->object.members[i], name, name_size) && !version--) {
+            *index = i;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool object_find_last_version(LibjJson *json, const char *name, size_t name_size, size_t *index) {
+    if (index_get(json)) {
+        IndexSlot *slot = find_slot(json, name_hash(name, name_size), name, name_size);
+        if (!slot->count) {
+            return false;
+        }
+        *index = slot->last;
+        return true;
+    }
+    for (size_t i = json->object.size; i--;) {
+        if (has_name(&json->object.members[i], name, name_size)) {
+            *index = i;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool object_find_last_symbol(LibjJson *json, const LibjSymbol *symbol, size_t *index) {
+    if (index_get(json)) {
+        IndexSlot *slot = find_slot(json, symbol->hash, symbol->name, symbol->size);
+        if (!slot->count) {
+            return false;
+        }
+        *index = slot->last;
+        return true;
+    }
+    for (size_t i = json->object.size; i--;) {
+        if (has_symbol(&json->object.members[i], symbol)) {
+            *index = i;
+            return true;
+        }
+    }
+    return false;
+}
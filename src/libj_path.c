@@ -0,0 +1,171 @@
+#include "libj_internal.h"
+
+#include <stdint.h>
+#include <string.h>
+
+/* Member names of every nesting level interned in advance. */
+struct LibjPath_ {
+    size_t size;
+    const LibjSymbol *symbols[];
+};
+
+LibjError libj_path_compile_(Libj *libj, LibjPath **path, const char *name, ...) {
+    va_list args;
+    va_start(args, name);
+    LibjError err = libj_path_compile_v(libj, path, name, args);
+    va_end(args);
+    return err;
+}
+
+LibjError libj_path_compile_v(Libj *libj, LibjPath **path, const char *name, va_list args) {
+    LibjError err = LIBJ_ERROR_OK;
+    LibjPath *result = NULL;
+    va_list count_args;
+    size_t size = 0;
+    if (!libj || !path || !name) {
+        err = LIBJ_ERROR_BAD_ARGUMENT;
+        goto end;
+    }
+    va_copy(count_args, args);
+    for (const char *next = name; next; next = va_arg(count_args, const char *)) {
+        ++size;
+    }
+    va_end(count_args);
+    if ((SIZE_MAX - sizeof(LibjPath)) / sizeof(LibjSymbol *) < size) {
+        err = LIBJ_ERROR_OUT_OF_MEMORY;
+        goto end;
+    }
+    result = malloc(sizeof(LibjPath) + size * sizeof(LibjSymbol *));
+    if (!result) {
+        err = LIBJ_ERROR_OUT_OF_MEMORY;
+        goto end;
+    }
+    result->size = size;
+    for (size_t i = 0; i < size; ++i) {
+        err = E(libj_intern(libj, name, strlen(name), &result->symbols[i]));
+        if (err) goto end;
+        name = va_arg(args, const char *);
+    }
+    *path = result;
+    result = NULL;
+end:
+    free(result);
+    return err;
+}
+
+LibjError libj_path_free(Libj *libj, LibjPath **path) {
+    LibjError err = LIBJ_ERROR_OK;
+    if (!libj || !path) {
+        err = LIBJ_ERROR_BAD_ARGUMENT;
+        goto end;
+    }
+    free(*path);
+    *path = NULL;
+end:
+    return err;
+}
+
+LibjError libj_path_get(Libj *libj, LibjJson *json, LibjPath *path, LibjJson **value) {
+    LibjError err = LIBJ_ERROR_OK;
+    if (!libj || !json || !path || !value) {
+        err = LIBJ_ERROR_BAD_ARGUMENT;
+        goto end;
+    }
+    *value = NULL;
+    for (size_t i = 0; i < path->size; ++i) {
+        if (LIBJ_TYPE_OBJECT != json->type) {
+            err = LIBJ_ERROR_BAD_TYPE;
+            goto end;
+        }
+        size_t index;
+        if (!object_find_last_symbol(json, path->symbols[i], &index)) {
+            err = LIBJ_ERROR_NOT_FOUND;
+            goto end;
+        }
+        json = json->object.members[index].value;
+    }
+    *value = json;
+end:
+    return err;
+}
+
+LibjError libj_path_get_string(Libj *libj, LibjJson *json, LibjPath *path, char **value) {
+    LibjError err = LIBJ_ERROR_OK;
+    if (!libj || !json || !path || !value) {
+        err = LIBJ_ERROR_BAD_ARGUMENT;
+        goto end;
+    }
+    *value = NULL;
+    /* Wrong types are errors of the input rather than of the caller, so they are returned as they are. */
+    LibjJson *json_value;
+    err = libj_path_get(libj, json, path, &json_value);
+    if (err) goto end;
+    err = libj_get_string(libj, json_value, value);
+    if (err) goto end;
+end:
+    return err;
+}
+
+LibjError libj_path_get_integer(Libj *libj, LibjJson *json, LibjPath *path, int64_t *value) {
+    LibjError err = LIBJ_ERROR_OK;
+    if (!libj || !json || !path || !value) {
+        err = LIBJ_ERROR_BAD_ARGUMENT;
+        goto end;
+    }
+    *value = 0;
+    LibjJson *json_value;
+    err = libj_path_get(libj, json, path, &json_value);
+    if (err) goto end;
+    err = libj_get_integer(libj, json_value, value);
+    if (err) goto end;
+end:
+    return err;
+}
+
+LibjError libj_path_get_real(Libj *libj, LibjJson *json, LibjPath *path, double *value) {
+    LibjError err = LIBJ_ERROR_OK;
+    if (!libj || !json || !path || !value) {
+        err = LIBJ_ERROR_BAD_ARGUMENT;
+        goto end;
+    }
+    *value = 0;
+    LibjJson *json_value;
+    err = libj_path_get(libj, json, path, &json_value);
+    if (err) goto end;
+    err = libj_get_real(libj, json_value, value);
+    if (err) goto end;
+end:
+    return err;
+}
+
+LibjError libj_path_get_number(Libj *libj, LibjJson *json, LibjPath *path, char **value) {
+    LibjError err = LIBJ_ERROR_OK;
+    if (!libj || !json || !path || !value) {
+        err = LIBJ_ERROR_BAD_ARGUMENT;
+        goto end;
+    }
+    *value = NULL;
+    LibjJson *json_value;
+    err = libj_path_get(libj, json, path, &json_value);
+    if (err) goto end;
+    err = libj_get_number(libj, json_value, value);
+    if (err) goto end;
+end:
+    return err;
+}
+
+LibjError libj_path_get_bool(Libj *libj, LibjJson *json, LibjPath *path, bool *value) {
+    LibjError err = LIBJ_ERROR_OK;
+    if (!libj || !json || !path || !value) {
+        err = LIBJ_ERROR_BAD_ARGUMENT;
+        goto end;
+    }
+    *value = false;
+    LibjJson *json_value;
+    err = libj_path_get(libj, json, path, &json_value);
+    if (err) goto end;
+    err = libj_get_bool(libj, json_value, value);
+    if (err) goto end;
+end:
+    return err;
+}
@@ -0,0 +1,482 @@
+#include "libj_internal.h"
+#include "libj_utils.h"
+#include "libj_simd.h"
+
+#include <stdio.h>
+#include <string.h>
+
+/* What the reader expects to find next. */
+typedef enum {
+    READER_START,         /* byte order mark or the value */
+    READER_VALUE,         /* a value */
+    READER_FIRST_KEY,     /* first member name or end of object */
+    READER_FIRST_ELEMENT, /* first element or end of array */
+    READER_KEY,           /* member name after a comma */
+    READER_NEXT,          /* comma or end of the innermost container */
+    READER_DONE,          /* nothing, the value is over */
+} ReaderState;
+
+struct LibjReader_ {
+    LibjInput input;
+    LibjParser parser; /* reads scalars and reports them to the callbacks below */
+    LibjToken *token; /* token that the callbacks fill */
+    ReaderState state;
+    LibjError failed;
+    char *error_string; /* copy of the message of the failure, NULL if there was none */
+    size_t depth;
+    bool objects[LIBJ_MAX_DEPTH]; /* whether each open container is an object, innermost last */
+};
+
+static bool read_null(void *user) {
+    LibjReader *reader = user;
+    reader->token->type = LIBJ_TOKEN_NULL;
+    return true;
+}
+
+static bool read_bool(void *user, bool value) {
+    LibjReader *reader = user;
+    reader->token->type = value ? LIBJ_TOKEN_TRUE : LIBJ_TOKEN_FALSE;
+    return true;
+}
+
+static bool read_number(void *user, const char *text, size_t text_size) {
+    LibjReader *reader = user;
+    reader->token->type = LIBJ_TOKEN_NUMBER;
+    reader->token->value = text;
+    reader->token->value_size = text_size;
+    return true;
+}
+
+static bool read_string(void *user, const char *value, size_t value_size) {
+    LibjReader *reader = user;
+    reader->token->type = LIBJ_TOKEN_STRING;
+    reader->token->value = value;
+    reader->token->value_size = value_size;
+    return true;
+}
+
+/* Arrays and objects are never passed to the parser, only scalars are. */
+static const LibjHandler reader_handler = {
+        .on_null = read_null,
+        .on_bool = read_bool,
+        .on_number = read_number,
+        .on_string = read_string,
+};
+
+static LibjError reader_create(Libj *libj, LibjReader **reader) {
+    LibjError err = LIBJ_ERROR_OK;
+    LibjReader *result = NULL;
+    if (!libj || !reader) {
+        err = LIBJ_ERROR_BAD_ARGUMENT;
+        goto end;
+    }
+    result = malloc(sizeof(LibjReader));
+    if (!result) {
+        err = LIBJ_ERROR_OUT_OF_MEMORY;
+        goto end;
+    }
+    parser_init(&result->parser, libj, &result->input, &reader_handler, result);
+    result->token = NULL;
+    result->state = READER_START;
+    result->failed = LIBJ_ERROR_OK;
+    result->error_string = NULL;
+    result->depth = 0;
+    *reader = result;
+    result = NULL;
+end:
+    free(result);
+    return err;
+}
+
+LibjError libj_reader_create(Libj *libj, LibisInputStream *input, LibjReader **reader) {
+    LibjError err = LIBJ_ERROR_OK;
+    if (!libj || !input || !reader) {
+        err = LIBJ_ERROR_BAD_ARGUMENT;
+        goto end;
+    }
+    err = E(reader_create(libj, reader));
+    if (err) goto end;
+    libj_input_from_stream(&(*reader)->input, input);
+end:
+    return err;
+}
+
+LibjError libj_reader_create_from_buffer(Libj *libj, const char *buffer, size_t buffer_size, LibjReader **reader) {
+    LibjError err = LIBJ_ERROR_OK;
+    if (!libj || !buffer || !reader) {
+        err = LIBJ_ERROR_BAD_ARGUMENT;
+        goto end;
+    }
+    err = E(reader_create(libj, reader));
+    if (err) goto end;
+    libj_input_from_buffer(&(*reader)->input, buffer, buffer_size);
+end:
+    return err;
+}
+
+LibjError libj_reader_free(Libj *libj, LibjReader **reader) {
+    LibjError err = LIBJ_ERROR_OK;
+    if (!libj || !reader) {
+        err = LIBJ_ERROR_BAD_ARGUMENT;
+        goto end;
+    }
+    if (*reader) {
+        free((*reader)->parser.scratch.bytes);
+        free((*reader)->error_string);
+    }
+    free(*reader);
+    *reader = NULL;
+end:
+    return err;
+}
+
+/* State after a value has been read. */
+static ReaderState after_value(LibjReader *reader) {
+    return reader->depth ? READER_NEXT : READER_DONE;
+}
+
+/* Find out what comes next in the innermost container and move past the comma before it. *closing is set if the
+ * container ends instead, its closing bracket is left in input then. */
+static LibjError find_next(LibjReader *reader, bool *closing) {
+    LibjError err = LIBJ_ERROR_OK;
+    char c;
+    bool eof;
+    if (!reader || !closing || !reader->depth) {
+        err = LIBJ_ERROR_BAD_ARGUMENT;
+        goto end;
+    }
+    Libj *libj = reader->parser.libj;
+    bool object = reader->objects[reader->depth - 1];
+    err = libj_skip_whitespace(libj, &reader->input, &eof, &c);
+    if (err) goto end;
+    *closing = (object ? '}' : ']') == c;
+    if (*closing) {
+        goto end;
+    }
+    if (READER_NEXT == reader->state) {
+        if (',' != c) {
+            E(errorf(libj, object ? "} or , was expected" : "] or , was expected", 0));
+            err = LIBJ_ERROR_SYNTAX;
+            goto end;
+        }
+        err = libj_input_skip_char(libj, &reader->input, &eof, &c);
+        if (err) goto end;
+    }
+    reader->state = object ? READER_KEY : READER_VALUE;
+end:
+    return err;
+}
+
+static LibjError open_container(LibjReader *reader, bool object) {
+    LibjError err = LIBJ_ERROR_OK;
+    char c;
+    bool eof;
+    if (!reader) {
+        err = LIBJ_ERROR_BAD_ARGUMENT;
+        goto end;
+    }
+    Libj *libj = reader->parser.libj;
+    if (LIBJ_MAX_DEPTH == reader->depth) {
+        E(errorf(libj, "too many nesting levels", 0));
+        err = LIBJ_ERROR_SYNTAX;
+        goto end;
+    }
+    err = libj_input_skip_char(libj, &reader->input, &eof, &c);
+    if (err) goto end;
+    reader->objects[reader->depth++] = object;
+    reader->token->type = object ? LIBJ_TOKEN_OBJECT_START : LIBJ_TOKEN_ARRAY_START;
+    reader->state = object ? READER_FIRST_KEY : READER_FIRST_ELEMENT;
+end:
+    return err;
+}
+
+static LibjError close_container(LibjReader *reader) {
+    LibjError err = LIBJ_ERROR_OK;
+    char c;
+    bool eof;
+    if (!reader || !reader->depth) {
+        err = LIBJ_ERROR_BAD_ARGUMENT;
+        goto end;
+    }
+    err = libj_input_skip_char(reader->parser.libj, &reader->input, &eof, &c);
+    if (err) goto end;
+    bool object = reader->objects[--reader->depth];
+    reader->token->type = object ? LIBJ_TOKEN_OBJECT_END : LIBJ_TOKEN_ARRAY_END;
+    reader->state = after_value(reader);
+end:
+    return err;
+}
+
+static LibjError read_token(LibjReader *reader) {
+    LibjError err = LIBJ_ERROR_OK;
+    char c;
+    bool eof;
+    if (!reader || !reader->token) {
+        err = LIBJ_ERROR_BAD_ARGUMENT;
+        goto end;
+    }
+    Libj *libj = reader->parser.libj;
+    LibjInput *input = &reader->input;
+    for (;;) {
+        bool closing;
+        switch (reader->state) {
+        case READER_START:
+            err = E(libj_skip_bom(libj, input));
+            if (err) goto end;
+            reader->state = READER_VALUE;
+            break;
+        case READER_VALUE:
+            err = libj_skip_whitespace(libj, input, &eof, &c);
+            if (err) goto end;
+            if ('{' == c || '[' == c) {
+                err = E(open_container(reader, '{' == c));
+                goto end;
+            }
+            err = E(libj_parse_value(&reader->parser));
+            if (err) goto end;
+            reader->state = after_value(reader);
+            goto end;
+        case READER_FIRST_KEY:
+        case READER_FIRST_ELEMENT:
+        case READER_NEXT:
+            err = E(find_next(reader, &closing));
+            if (err) goto end;
+            if (closing) {
+                err = E(close_container(reader));
+                goto end;
+            }
+            break;
+        case READER_KEY:
+            err = E(libj_parse_value_string(&reader->parser));
+            if (err) goto end;
+            reader->token->type = LIBJ_TOKEN_KEY;
+            err = E(libj_skip_literal(libj, input, ":"));
+            if (err) goto end;
+            reader->state = READER_VALUE;
+            goto end;
+        case READER_DONE:
+            reader->token->type = LIBJ_TOKEN_END;
+            goto end;
+        }
+    }
+end:
+    return err;
+}
+
+/* Skip string that starts at the quote input is at. */
+static LibjError skip_string(LibjReader *reader) {
+    LibjError err = LIBJ_ERROR_OK;
+    char c;
+    bool eof;
+    if (!reader) {
+        err = LIBJ_ERROR_BAD_ARGUMENT;
+        goto end;
+    }
+    Libj *libj = reader->parser.libj;
+    LibjInput *input = &reader->input;
+    err = libj_input_skip_char(libj, input, &eof, &c);
+    if (err) goto end;
+    for (;;) {
+        if (!input->stream) {
+            input->current += libj_simd_scan_string(input->current, input->end);
+        }
+        err = libj_input_lookahead(libj, input, &eof, &c);
+        if (err) goto end;
+        if (eof) {
+            E(errorf(libj, "unexpected end of file", 0));
+            err = LIBJ_ERROR_SYNTAX;
+            goto end;
+        }
+        if ('\\' == c) {
+            /* Escaped character is never a quote that ends the string. */
+            err = libj_input_skip_char(libj, input, &eof, &c);
+            if (err) goto end;
+        } else if ('"' == c) {
+            err = libj_input_skip_char(libj, input, &eof, &c);
+            goto end;
+        }
+        err = libj_input_skip_char(libj, input, &eof, &c);
+        if (err) goto end;
+    }
+end:
+    return err;
+}
+
+/* Skip array or object that starts at the bracket input is at. */
+static LibjError skip_container(LibjReader *reader) {
+    LibjError err = LIBJ_ERROR_OK;
+    char closing[LIBJ_MAX_DEPTH];
+    size_t depth = 0;
+    char c;
+    bool eof;
+    if (!reader) {
+        err = LIBJ_ERROR_BAD_ARGUMENT;
+        goto end;
+    }
+    Libj *libj = reader->parser.libj;
+    LibjInput *input = &reader->input;
+    err = libj_input_lookahead(libj, input, &eof, &c);
+    if (err) goto end;
+    do {
+        switch (c) {
+        case '{':
+        case '[':
+            if (LIBJ_MAX_DEPTH == reader->depth + depth) {
+                E(errorf(libj, "too many nesting levels", 0));
+                err = LIBJ_ERROR_SYNTAX;
+                goto end;
+            }
+            closing[depth++] = '{' == c ? '}' : ']';
+            break;
+        case '}':
+        case ']':
+            if (closing[depth - 1] != c) {
+                E(errorf(libj, "'%c' was expected", closing[depth - 1]));
+                err = LIBJ_ERROR_SYNTAX;
+                goto end;
+            }
+            --depth;
+            break;
+        case '"':
+            err = E(skip_string(reader));
+            if (err) goto end;
+            err = libj_input_lookahead(libj, input, &eof, &c);
+            if (err) goto end;
+            continue;
+        default:
+            if (eof) {
+                E(errorf(libj, "unexpected end of file", 0));
+                err = LIBJ_ERROR_SYNTAX;
+                goto end;
+            }
+            break;
+        }
+        err = libj_input_skip_char(libj, input, &eof, &c);
+        if (err) goto end;
+    } while (depth);
+end:
+    return err;
+}
+
+static LibjError skip_value(LibjReader *reader) {
+    LibjError err = LIBJ_ERROR_OK;
+    LibjToken token;
+    char c;
+    bool eof;
+    if (!reader) {
+        err = LIBJ_ERROR_BAD_ARGUMENT;
+        goto end;
+    }
+    Libj *libj = reader->parser.libj;
+    LibjInput *input = &reader->input;
+    reader->token = &token;
+    for (;;) {
+        bool closing;
+        switch (reader->state) {
+        case READER_START:
+            err = E(libj_skip_bom(libj, input));
+            if (err) goto end;
+            reader->state = READER_VALUE;
+            break;
+        case READER_KEY:
+            /* Member name is skipped together with its value. */
+            err = E(read_token(reader));
+            if (err) goto end;
+            break;
+        case READER_VALUE:
+            err = libj_skip_whitespace(libj, input, &eof, &c);
+            if (err) goto end;
+            if ('{' == c || '[' == c) {
+                err = E(skip_container(reader));
+                if (err) goto end;
+                reader->state = after_value(reader);
+                goto end;
+            }
+            if ('"' == c) {
+                err = E(skip_string(reader));
+                if (err) goto end;
+                reader->state = after_value(reader);
+                goto end;
+            }
+            err = E(read_token(reader));
+            goto end;
+        case READER_FIRST_KEY:
+        case READER_FIRST_ELEMENT:
+        case READER_NEXT:
+            err = E(find_next(reader, &closing));
+            if (err || closing) goto end;
+            break;
+        case READER_DONE:
+            goto end;
+        }
+    }
+end:
+    if (reader) reader->token = NULL;
+    return err;
+}
+
+/* Remember that reading failed with err. The message is copied since later calls with libj replace its own. */
+static void reader_fail(Libj *libj, LibjReader *reader, LibjError err) {
+    reader->failed = err;
+    if (libj->error_string) {
+        reader->error_string = strdup(libj->error_string);
+    }
+}
+
+/* Message of the failure of reader. */
+static const char *reader_error_string(LibjReader *reader) {
+    return reader->error_string ? reader->error_string : libj_error_to_human_readable_string(reader->failed);
+}
+
+LibjError libj_reader_next(Libj *libj, LibjReader *reader, LibjToken *token, const char **error_string) {
+    LibjError err = LIBJ_ERROR_OK;
+    if (!libj || !reader || !token || !error_string) {
+        err = LIBJ_ERROR_BAD_ARGUMENT;
+        goto end;
+    }
+    token->type = LIBJ_TOKEN_END;
+    token->value = NULL;
+    token->value_size = 0;
+    if (reader->failed) {
+        err = reader->failed;
+        *error_string = reader_error_string(reader);
+        goto end;
+    }
+    free(libj->error_string);
+    libj->error_string = NULL;
+    reader->token = token;
+    err = E(read_token(reader));
+    reader->token = NULL;
+    if (err) {
+        reader_fail(libj, reader, err);
+        *error_string = reader_error_string(reader);
+        goto end;
+    }
+    *error_string = "";
+end:
+    return err;
+}
+
+LibjError libj_reader_skip_value(Libj *libj, LibjReader *reader, const char **error_string) {
+    LibjError err = LIBJ_ERROR_OK;
+    if (!libj || !reader || !error_string) {
+        err = LIBJ_ERROR_BAD_ARGUMENT;
+        goto end;
+    }
+    if (reader->failed) {
+        err = reader->failed;
+        *error_string = reader_error_string(reader);
+        goto end;
+    }
+    free(libj->error_string);
+    libj->error_string = NULL;
+    err = E(skip_value(reader));
+    if (err) {
+        reader_fail(libj, reader, err);
+        *error_string = reader_error_string(reader);
+        goto end;
+    }
+    *error_string = "";
+end:
+    return err;
+}
@@ -0,0 +1,156 @@
+#include "libj_simd.h"
+
+#include <stdbool.h>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define LIBJ_SIMD_X86
+#include <immintrin.h>
+#endif
+
+static bool is_whitespace(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+static bool ends_string_run(char c) {
+    return c == '"' || c == '\\' || (unsigned char) c < 0x20;
+}
+
+static size_t skip_whitespace_scalar(const char *begin, const char *end) {
+    const char *p = begin;
+    while (p != end && is_whitespace(*p)) {
+        ++p;
+    }
+    return p - begin;
+}
+
+static size_t scan_string_scalar(const char *begin, const char *end) {
+    const char *p = begin;
+    while (p != end && !ends_string_run(*p)) {
+        ++p;
+    }
+    return p - begin;
+}
+
+#ifdef LIBJ_SIMD_X86
+
+__attribute__((target("sse2")))
+static size_t skip_whitespace_sse2(const char *begin, const char *end) {
+    const char *p = begin;
+    const __m128i space = _mm_set1_epi8(' ');
+    const __m128i tab = _mm_set1_epi8('\t');
+    const __m128i line_feed = _mm_set1_epi8('\n');
+    const __m128i carriage_return = _mm_set1_epi8('\r');
+    while (16 <= end - p) {
+        __m128i chunk = _mm_loadu_si128((const __m128i *) p);
+        __m128i whitespace = _mm_or_si128(
+                _mm_or_si128(_mm_cmpeq_epi8(chunk, space), _mm_cmpeq_epi8(chunk, tab)),
+                _mm_or_si128(_mm_cmpeq_epi8(chunk, line_feed), _mm_cmpeq_epi8(chunk, carriage_return)));
+        unsigned other = ~(unsigned) _mm_movemask_epi8(whitespace) & 0xFFFFu;
+        if (other) {
+            return p - begin + __builtin_ctz(other);
+        }
+        p += 16;
+    }
+    return p - begin + skip_whitespace_scalar(p, end);
+}
+
+__attribute__((target("avx2")))
+static size_t skip_whitespace_avx2(const char *begin, const char *end) {
+    const char *p = begin;
+    const __m256i space = _mm256_set1_epi8(' ');
+    const __m256i tab = _mm256_set1_epi8('\t');
+    const __m256i line_feed = _mm256_set1_epi8('\n');
+    const __m256i carriage_return = _mm256_set1_epi8('\r');
+    while (32 <= end - p) {
+        __m256i chunk = _mm256_loadu_si256((const __m256i *) p);
+        __m256i whitespace = _mm256_or_si256(
+                _mm256_or_si256(_mm256_cmpeq_epi8(chunk, space), _mm256_cmpeq_epi8(chunk, tab)),
+                _mm256_or_si256(_mm256_cmpeq_epi8(chunk, line_feed), _mm256_cmpeq_epi8(chunk, carriage_return)));
+        unsigned other = ~(unsigned) _mm256_movemask_epi8(whitespace);
+        if (other) {
+            return p - begin + __builtin_ctz(other);
+        }
+        p += 32;
+    }
+    return p - begin + skip_whitespace_sse2(p, end);
+}
+
+__attribute__((target("sse2")))
+static size_t scan_string_sse2(const char *begin, const char *end) {
+    const char *p = begin;
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i last_control = _mm_set1_epi8(0x1F);
+    while (16 <= end - p) {
+        __m128i chunk = _mm_loadu_si128((const __m128i *) p);
+        __m128i control = _mm_cmpeq_epi8(_mm_max_epu8(chunk, last_control), last_control);
+        __m128i stop = _mm_or_si128(
+                _mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash)),
+                control);
+        unsigned mask = (unsigned) _mm_movemask_epi8(stop);
+        if (mask) {
+            return p - begin + __builtin_ctz(mask);
+        }
+        p += 16;
+    }
+    return p - begin + scan_string_scalar(p, end);
+}
+
+__attribute__((target("avx2")))
+static size_t scan_string_avx2(const char *begin, const char *end) {
+    const char *p = begin;
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i backslash = _mm256_set1_epi8('\\');
+    const __m256i last_control = _mm256_set1_epi8(0x1F);
+    while (32 <= end - p) {
+        __m256i chunk = _mm256_loadu_si256((const __m256i *) p);
+        __m256i control = _mm256_cmpeq_epi8(_mm256_max_epu8(chunk, last_control), last_control);
+        __m256i stop = _mm256_or_si256(
+                _mm256_or_si256(_mm256_cmpeq_epi8(chunk, quote), _mm256_cmpeq_epi8(chunk, backslash)),
+                control);
+        unsigned mask = (unsigned) _mm256_movemask_epi8(stop);
+        if (mask) {
+            return p - begin + __builtin_ctz(mask);
+        }
+        p += 32;
+    }
+    return p - begin + scan_string_sse2(p, end);
+}
+
+#endif
+
+size_t libj_simd_skip_whitespace(const char *begin, const char *end) {
+    /* Compact json has no whitespace at all and pretty json mostly has one byte between tokens, so look at the
+     * first bytes before paying for a vector load. */
+    if (begin == end || !is_whitespace(begin[0])) {
+        return 0;
+    }
+    if (begin + 1 == end || !is_whitespace(begin[1])) {
+        return 1;
+    }
+#ifdef LIBJ_SIMD_X86
+    if (__builtin_cpu_supports("avx2")) {
+        return skip_whitespace_avx2(begin, end);
+    }
+    if (__builtin_cpu_supports("sse2")) {
+        return skip_whitespace_sse2(begin, end);
+    }
+#endif
+    return skip_whitespace_scalar(begin, end);
+}
+
+size_t libj_simd_scan_string(const char *begin, const char *end) {
+    /* Short strings such as member names are over before a vector would be filled. */
+    if (end - begin < 16) {
+        return scan_string_scalar(begin, end);
+    }
+#ifdef LIBJ_SIMD_X86
+    if (__builtin_cpu_supports("avx2")) {
+        return scan_string_avx2(begin, end);
+    }
+    if (__builtin_cpu_supports("sse2")) {
+        return scan_string_sse2(begin, end);
+    }
+#endif
+    return scan_string_scalar(begin, end);
+}
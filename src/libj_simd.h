@@ -0,0 +1,16 @@
+#ifndef LIBJ_SIMD_H
+#define LIBJ_SIMD_H
+
+#include <stddef.h>
+
+/* Scanners over contiguous input. Each of them uses the widest vector instructions the CPU running the program
+ * supports and falls back to plain C elsewhere. */
+
+/* Number of json whitespace characters at the beginning of [begin, end). */
+size_t libj_simd_skip_whitespace(const char *begin, const char *end);
+
+/* Number of bytes at the beginning of [begin, end) that can be copied into a string value as is, that is up to
+ * the first quote, backslash or control character. */
+size_t libj_simd_scan_string(const char *begin, const char *end);
+
+#endif
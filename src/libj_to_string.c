@@ -1,9 +1,14 @@
 #include "libj_internal.h"
+#include "libj_dtoa.h"
 
 #include <libutf.h>
 
 #include <assert.h>
-#include <locale.h>
+#include <errno.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
 
 #define INDENT_PLACEHOLDER "$"
 
@@ -53,158 +58,269 @@ LibjToStringOptions libj_to_string_options_compact = {
         .ascii_only = false,
 };
 
-static LibjError append_fragment(Libj *libj, const char *format, ...) {
+/* Option strings around a punctuation character, e.g. left_brace_prefix "{" left_brace_postfix, composed once per
+ * serialization. */
+typedef struct {
+    const char *text;
+    size_t size;
+    bool indented; /* whether text has indent placeholders */
+} Fragment;
+
+typedef enum {
+    FRAGMENT_LEFT_BRACKET,
+    FRAGMENT_RIGHT_BRACKET,
+    FRAGMENT_LEFT_BRACE,
+    FRAGMENT_RIGHT_BRACE,
+    FRAGMENT_COMMA_IN_OBJECT,
+    FRAGMENT_COMMA_IN_ARRAY,
+    FRAGMENT_COLON,
+    FRAGMENT_MEMBER_PREFIX,
+    FRAGMENT_MEMBER_POSTFIX,
+    FRAGMENT_ELEMENT_PREFIX,
+    FRAGMENT_ELEMENT_POSTFIX,
+    FRAGMENT_COUNT,
+} FragmentKind;
+
+/* Size of the buffer output is collected in before it's passed to a write callback. */
+#define CHUNK_SIZE 65536
+
+typedef struct {
+    char *data;
+    size_t size;
+    size_t capacity;
+    LibjWriteCallback write; /* NULL when output is collected into a string */
+    void *user;
+    int depth;
+    bool ascii_only;
+    const char *indent;
+    size_t indent_size;
+    Fragment fragments[FRAGMENT_COUNT];
+    char *fragments_text;
+} Writer;
+
+/* What a byte of a string value is written as. 0 means the byte itself, 'u' means \u00XX and anything else means
+ * a backslash followed by that character. */
+static const char escapes[256] = {
+        [0x00] = 'u', [0x01] = 'u', [0x02] = 'u', [0x03] = 'u', [0x04] = 'u', [0x05] = 'u', [0x06] = 'u',
+        [0x07] = 'u', ['\b'] = 'b', ['\t'] = 't', ['\n'] = 'n', [0x0B] = 'u', ['\f'] = 'f', ['\r'] = 'r',
+        [0x0E] = 'u', [0x0F] = 'u', [0x10] = 'u', [0x11] = 'u', [0x12] = 'u', [0x13] = 'u', [0x14] = 'u',
+        [0x15] = 'u', [0x16] = 'u', [0x17] = 'u', [0x18] = 'u', [0x19] = 'u', [0x1A] = 'u', [0x1B] = 'u',
+        [0x1C] = 'u', [0x1D] = 'u', [0x1E] = 'u', [0x1F] = 'u', ['"'] = '"', ['\\'] = '\\',
+};
+
+/* Make sure that size more bytes fit into output. */
+static LibjError reserve(Writer *writer, size_t size) {
     LibjError err = LIBJ_ERROR_OK;
-    LibsbBuilder *indent_builder = NULL;
-    LibsbBuilder *fragment_builder = NULL;
-    char *indent = NULL;
-    size_t indent_size = 0;
-    char *fragment = NULL;
-    size_t fragment_size = 0;
-    va_list args;
-    va_start(args, format);
-    if (!libj || !format) {
-        err = LIBJ_ERROR_BAD_ARGUMENT;
+    if (size <= writer->capacity - writer->size) {
         goto end;
     }
-    err = ESB(libsb_create(libj->libsb, &indent_builder));
-    if (err) goto end;
-    for (int i = 0; i < libj->depth; i++) {
-        err = ESB(libsb_append(libj->libsb, indent_builder, "%s", libj->to_string_options->indent_string));
-        if (err) goto end;
+    size_t capacity = writer->capacity ? writer->capacity : 256;
+    while (capacity - writer->size < size) {
+        if (SIZE_MAX / 2 < capacity) {
+            err = LIBJ_ERROR_OUT_OF_MEMORY;
+            goto end;
+        }
+        capacity *= 2;
     }
-    err = ESB(libsb_destroy_into(libj->libsb, &indent_builder, &indent, &indent_size));
-    if (err) goto end;
-    err = ESB(libsb_create(libj->libsb, &fragment_builder));
-    if (err) goto end;
-    err = ESB(libsb_append_v(libj->libsb, fragment_builder, format, args));
-    if (err) goto end;
-    err = ESB(libsb_replace(libj->libsb, fragment_builder, INDENT_PLACEHOLDER, indent));
-    if (err) goto end;
-    err = ESB(libsb_destroy_into(libj->libsb, &fragment_builder, &fragment, &fragment_size));
-    if (err) goto end;
-    err = ESB(libsb_append(libj->libsb, libj->builder, "%s", fragment));
-    if (err) goto end;
+    char *data = realloc(writer->data, capacity);
+    if (!data) {
+        err = LIBJ_ERROR_OUT_OF_MEMORY;
+        goto end;
+    }
+    writer->data = data;
+    writer->capacity = capacity;
+end:
+    return err;
+}
+
+/* Pass collected output to the write callback. */
+static LibjError flush(Writer *writer) {
+    LibjError err = LIBJ_ERROR_OK;
+    if (writer->size && !writer->write(writer->user, writer->data, writer->size)) {
+        err = LIBJ_ERROR_IO;
+        goto end;
+    }
+    writer->size = 0;
 end:
-    if (libj) {
-        ESB(libsb_destroy(libj->libsb, &indent_builder));
-        ESB(libsb_destroy(libj->libsb, &fragment_builder));
+    return err;
+}
+
+static LibjError write_bytes(Writer *writer, const char *bytes, size_t size) {
+    LibjError err = LIBJ_ERROR_OK;
+    if (!writer->write) {
+        err = E(reserve(writer, size));
+        if (err) goto end;
+    } else if (writer->capacity - writer->size < size) {
+        err = E(flush(writer));
+        if (err) goto end;
+        if (writer->capacity < size) {
+            if (!writer->write(writer->user, bytes, size)) {
+                err = LIBJ_ERROR_IO;
+            }
+            goto end;
+        }
     }
-    free(fragment);
-    free(indent);
-    va_end(args);
+    memcpy(writer->data + writer->size, bytes, size);
+    writer->size += size;
+end:
     return err;
 }
 
-static LibjError append_string(Libj *libj, LibjString string) {
+static LibjError write_fragment(Writer *writer, FragmentKind kind) {
     LibjError err = LIBJ_ERROR_OK;
-    if (!libj) {
-        err = LIBJ_ERROR_BAD_ARGUMENT;
+    Fragment fragment = writer->fragments[kind];
+    if (!fragment.indented) {
+        err = E(write_bytes(writer, fragment.text, fragment.size));
         goto end;
     }
-    err = E(append_fragment(libj, "\""));
-    if (err) goto end;
-    for (char *p = string.value, *end = string.value + string.size; p != end; ++p) {
-        char c = *p;
-        if (libj->to_string_options->ascii_only) {
-            uint16_t c16[2];
-            uint32_t c32;
-            LibutfC8Type type = libutf_c8_type(c);
-            if (type < 0) {
-                err = LIBJ_ERROR_SYNTAX;
+    const char *p = fragment.text;
+    const char *end = fragment.text + fragment.size;
+    for (;;) {
+        const char *placeholder = memchr(p, INDENT_PLACEHOLDER[0], end - p);
+        if (!placeholder) {
+            err = E(write_bytes(writer, p, end - p));
+            goto end;
+        }
+        err = E(write_bytes(writer, p, placeholder - p));
+        if (err) goto end;
+        for (int i = 0; i < writer->depth; ++i) {
+            err = E(write_bytes(writer, writer->indent, writer->indent_size));
+            if (err) goto end;
+        }
+        p = placeholder + 1;
+    }
+end:
+    return err;
+}
+
+/* Compose fragments of options into a single allocation. */
+static LibjError compose_fragments(Writer *writer, LibjToStringOptions *options) {
+    LibjError err = LIBJ_ERROR_OK;
+    const char *parts[FRAGMENT_COUNT][3] = {
+            [FRAGMENT_LEFT_BRACKET] = { options->left_bracket_prefix, "[", options->left_bracket_postfix },
+            [FRAGMENT_RIGHT_BRACKET] = { options->right_bracket_prefix, "]", options->right_bracket_postfix },
+            [FRAGMENT_LEFT_BRACE] = { options->left_brace_prefix, "{", options->left_brace_postfix },
+            [FRAGMENT_RIGHT_BRACE] = { options->right_brace_prefix, "}", options->right_brace_postfix },
+            [FRAGMENT_COMMA_IN_OBJECT] = { options->comma_in_object_prefix, ",", options->comma_in_object_postfix },
+            [FRAGMENT_COMMA_IN_ARRAY] = { options->comma_in_array_prefix, ",", options->comma_in_array_postfix },
+            [FRAGMENT_COLON] = { options->colon_prefix, ":", options->colon_postfix },
+            [FRAGMENT_MEMBER_PREFIX] = { options->member_prefix, "", "" },
+            [FRAGMENT_MEMBER_POSTFIX] = { options->member_postfix, "", "" },
+            [FRAGMENT_ELEMENT_PREFIX] = { options->element_prefix, "", "" },
+            [FRAGMENT_ELEMENT_POSTFIX] = { options->element_postfix, "", "" },
+    };
+    size_t total_size = 0;
+    for (int kind = 0; kind < FRAGMENT_COUNT; ++kind) {
+        for (int part = 0; part < 3; ++part) {
+            if (!parts[kind][part]) {
+                err = LIBJ_ERROR_BAD_ARGUMENT;
                 goto end;
             }
-            int n = type;
-            if (1 < n) {
-                if (!libutf_c8_to_c32(p, &c32)) {
-                    err = LIBJ_ERROR_SYNTAX;
-                    goto end;
-                }
-                int length;
-                if (!libutf_c32_to_c16(c32, &length, c16)) {
-                    err = LIBJ_ERROR_SYNTAX;
-                    goto end;
-                }
-                err = E(append_fragment(libj, "\\u%04x", c16[0]));
-                if (err) goto end;
-                if (c16[0]) {
-                    err = E(append_fragment(libj, "\\u%04x", c16[1]));
-                    if (err) goto end;
-                }
-                p += n - 1;
-                continue;
-            }
+            total_size += strlen(parts[kind][part]);
         }
-        switch (c) {
-        case '\"':
-        case '\\':
-            err = E(append_fragment(libj, "\\%c", c));
-            break;
-        case '\b':
-            err = E(append_fragment(libj, "\\b"));
-            break;
-        case '\f':
-            err = E(append_fragment(libj, "\\f"));
-            break;
-        case '\n':
-            err = E(append_fragment(libj, "\\n"));
-            break;
-        case '\r':
-            err = E(append_fragment(libj, "\\r"));
-            break;
-        case '\t':
-            err = E(append_fragment(libj, "\\t"));
-            break;
-        default:
-            if ((unsigned char) c < 0x20) {
-                err = E(append_fragment(libj, "\\u%04x", (unsigned char) c));
-            } else {
-                err = E(append_fragment(libj, "%c", c));
-            }
-            break;
+    }
+    writer->fragments_text = malloc(total_size + 1);
+    if (!writer->fragments_text) {
+        err = LIBJ_ERROR_OUT_OF_MEMORY;
+        goto end;
+    }
+    char *p = writer->fragments_text;
+    for (int kind = 0; kind < FRAGMENT_COUNT; ++kind) {
+        Fragment *fragment = &writer->fragments[kind];
+        fragment->text = p;
+        for (int part = 0; part < 3; ++part) {
+            size_t size = strlen(parts[kind][part]);
+            memcpy(p, parts[kind][part], size);
+            p += size;
         }
-        if (err) goto end;
+        fragment->size = p - fragment->text;
+        fragment->indented = memchr(fragment->text, INDENT_PLACEHOLDER[0], fragment->size);
     }
-    err = E(append_fragment(libj, "\""));
-    if (err) goto end;
 end:
     return err;
 }
 
-static LibjError append_number(Libj *libj, const char *number) {
+static LibjError write_escaped_code_unit(Writer *writer, uint16_t c16) {
+    static const char hex[] = "0123456789abcdef";
+    char bytes[6] = { '\\', 'u', hex[c16 >> 12], hex[(c16 >> 8) & 0xF], hex[(c16 >> 4) & 0xF], hex[c16 & 0xF] };
+    return E(write_bytes(writer, bytes, sizeof(bytes)));
+}
+
+/* Write multibyte UTF-8 character at p as one or two \u escapes. *n is set to the length of the character. */
+static LibjError write_escaped_character(Writer *writer, const char *p, const char *end, int *n) {
     LibjError err = LIBJ_ERROR_OK;
-    LibsbBuilder *builder = NULL;
-    char *good_number = NULL; // number with locale dependent decimal comma replaced with '.'
-    size_t good_number_size = 0;
-    locale_t previous_locale = uselocale(0);
-    if (!libj || !number) {
-        err = LIBJ_ERROR_BAD_ARGUMENT;
+    LibutfC8Type type = libutf_c8_type(*p);
+    if (type < 0 || end - p < type) {
+        err = LIBJ_ERROR_SYNTAX;
         goto end;
     }
-    uselocale(libj->c_locale);
-    err = ESB(libsb_create(libj->libsb, &builder));
-    if (err) goto end;
-    err = ESB(libsb_append(libj->libsb, builder, "%s", number));
-    if (err) goto end;
-    struct lconv * lconv = localeconv();
-    err = ESB(libsb_replace(libj->libsb, builder, lconv->decimal_point, "."));
-    if (err) goto end;
-    err = ESB(libsb_destroy_into(libj->libsb, &builder, &good_number, &good_number_size));
+    *n = type;
+    char c8[5] = { 0 };
+    memcpy(c8, p, *n);
+    uint32_t c32;
+    if (!libutf_c8_to_c32(c8, &c32)) {
+        err = LIBJ_ERROR_SYNTAX;
+        goto end;
+    }
+    uint16_t c16[2];
+    int length;
+    if (!libutf_c32_to_c16(c32, &length, c16)) {
+        err = LIBJ_ERROR_SYNTAX;
+        goto end;
+    }
+    for (int i = 0; i < length; ++i) {
+        err = E(write_escaped_code_unit(writer, c16[i]));
+        if (err) goto end;
+    }
+end:
+    return err;
+}
+
+static LibjError write_string(Writer *writer, LibjString string) {
+    LibjError err = LIBJ_ERROR_OK;
+    err = E(write_bytes(writer, "\"", 1));
     if (err) goto end;
-    err = E(append_fragment(libj, "%s", good_number));
+    const char *p = string.value;
+    const char *end = string.value + string.size;
+    unsigned char ascii_mask = writer->ascii_only ? 0x80 : 0x00;
+    for (;;) {
+        const char *run = p;
+        while (p != end && !escapes[(unsigned char) *p] && !(*p & ascii_mask)) {
+            ++p;
+        }
+        err = E(write_bytes(writer, run, p - run));
+        if (err) goto end;
+        if (p == end) {
+            break;
+        }
+        unsigned char c = (unsigned char) *p;
+        if (c & ascii_mask) {
+            int n;
+            err = E(write_escaped_character(writer, p, end, &n));
+            if (err) goto end;
+            p += n;
+        } else if ('u' == escapes[c]) {
+            err = E(write_escaped_code_unit(writer, c));
+            if (err) goto end;
+            ++p;
+        } else {
+            char escape[2] = { '\\', escapes[c] };
+            err = E(write_bytes(writer, escape, sizeof(escape)));
+            if (err) goto end;
+            ++p;
+        }
+    }
+    err = E(write_bytes(writer, "\"", 1));
     if (err) goto end;
 end:
-    uselocale(previous_locale);
-    free(good_number);
-    ESB(libsb_destroy(libj->libsb, &builder));
     return err;
 }
 
-static LibjError append_json(Libj *libj, LibjJson *json);
+static LibjError write_json(Writer *writer, LibjJson *json);
 
-static LibjError append_object(Libj *libj, LibjJson *json) {
+static LibjError write_object(Writer *writer, LibjJson *json) {
     LibjError err = LIBJ_ERROR_OK;
-    if (!libj || !json) {
+    if (!writer || !json) {
         err = LIBJ_ERROR_BAD_ARGUMENT;
         goto end;
     }
@@ -212,44 +328,36 @@ static LibjError append_object(Libj *libj, LibjJson *json) {
         err = LIBJ_ERROR_BAD_TYPE;
         goto end;
     }
-    err = E(append_fragment(libj, "%s{%s",
-                            libj->to_string_options->left_brace_prefix,
-                            libj->to_string_options->left_brace_postfix));
+    err = E(write_fragment(writer, FRAGMENT_LEFT_BRACE));
     if (err) goto end;
-    ++libj->depth;
+    ++writer->depth;
     for (size_t i = 0; i < json->object.size; ++i) {
         if (i) {
-            err = E(append_fragment(libj, "%s,%s",
-                                    libj->to_string_options->comma_in_object_prefix,
-                                    libj->to_string_options->comma_in_object_postfix));
+            err = E(write_fragment(writer, FRAGMENT_COMMA_IN_OBJECT));
             if (err) goto end;
         }
-        err = E(append_fragment(libj, "%s", libj->to_string_options->member_prefix));
+        err = E(write_fragment(writer, FRAGMENT_MEMBER_PREFIX));
         if (err) goto end;
         LibjMember member = json->object.members[i];
-        err = E(append_string(libj, member.name));
+        err = E(write_string(writer, member.name));
         if (err) goto end;
-        err = E(append_fragment(libj, "%s:%s",
-                                libj->to_string_options->colon_prefix,
-                                libj->to_string_options->colon_postfix));
+        err = E(write_fragment(writer, FRAGMENT_COLON));
         if (err) goto end;
-        err = E(append_json(libj, member.value));
+        err = E(write_json(writer, member.value));
         if (err) goto end;
-        err = E(append_fragment(libj, "%s", libj->to_string_options->member_postfix));
+        err = E(write_fragment(writer, FRAGMENT_MEMBER_POSTFIX));
         if (err) goto end;
     }
-    --libj->depth;
-    err = E(append_fragment(libj, "%s}%s",
-                            libj->to_string_options->right_brace_prefix,
-                            libj->to_string_options->right_brace_postfix));
+    --writer->depth;
+    err = E(write_fragment(writer, FRAGMENT_RIGHT_BRACE));
     if (err) goto end;
 end:
     return err;
 }
 
-static LibjError append_array(Libj *libj, LibjJson *json) {
+static LibjError write_array(Writer *writer, LibjJson *json) {
     LibjError err = LIBJ_ERROR_OK;
-    if (!libj || !json) {
+    if (!writer || !json) {
         err = LIBJ_ERROR_BAD_ARGUMENT;
         goto end;
     }
@@ -257,58 +365,57 @@ static LibjError append_array(Libj *libj, LibjJson *json) {
         err = LIBJ_ERROR_BAD_TYPE;
         goto end;
     }
-    err = E(append_fragment(libj, "%s[%s",
-                            libj->to_string_options->left_bracket_prefix,
-                            libj->to_string_options->left_bracket_postfix));
+    err = E(write_fragment(writer, FRAGMENT_LEFT_BRACKET));
     if (err) goto end;
-    ++libj->depth;
+    ++writer->depth;
     for (size_t i = 0; i < json->array.size; ++i) {
         if (i) {
-            err = E(append_fragment(libj, "%s,%s",
-                                    libj->to_string_options->comma_in_array_prefix,
-                                    libj->to_string_options->comma_in_array_postfix));
+            err = E(write_fragment(writer, FRAGMENT_COMMA_IN_ARRAY));
             if (err) goto end;
         }
-        err = E(append_fragment(libj, "%s", libj->to_string_options->element_prefix));
+        err = E(write_fragment(writer, FRAGMENT_ELEMENT_PREFIX));
         if (err) goto end;
-        err = E(append_json(libj, json->array.elements[i]));
+        err = E(write_json(writer, json->array.elements[i]));
         if (err) goto end;
-        err = E(append_fragment(libj, "%s", libj->to_string_options->element_postfix));
+        err = E(write_fragment(writer, FRAGMENT_ELEMENT_POSTFIX));
         if (err) goto end;
     }
-    --libj->depth;
-    err = E(append_fragment(libj, "%s]%s",
-                            libj->to_string_options->right_bracket_prefix,
-                            libj->to_string_options->right_bracket_postfix));
+    --writer->depth;
+    err = E(write_fragment(writer, FRAGMENT_RIGHT_BRACKET));
     if (err) goto end;
 end:
     return err;
 }
 
-static LibjError append_json(Libj *libj, LibjJson *json) {
+static LibjError write_json(Writer *writer, LibjJson *json) {
     LibjError err = LIBJ_ERROR_OK;
-    if (!libj || !json) {
+    if (!writer || !json) {
         err = LIBJ_ERROR_BAD_ARGUMENT;
         goto end;
     }
     switch (json->type) {
     case LIBJ_TYPE_NULL:
-        err = E(append_fragment(libj, "null"));
+        err = E(write_bytes(writer, "null", 4));
         break;
     case LIBJ_TYPE_STRING:
-        err = E(append_string(libj, json->string));
+        err = E(write_string(writer, json->string));
         break;
     case LIBJ_TYPE_NUMBER:
-        err = E(append_number(libj, json->string.value));
+        if (json->number.text.value) {
+            err = E(write_bytes(writer, json->number.text.value, json->number.text.size));
+        } else {
+            char text[LIBJ_DOUBLE_BUFFER_SIZE];
+            err = E(write_bytes(writer, text, number_format(&json->number, text)));
+        }
         break;
     case LIBJ_TYPE_BOOL:
-        err = E(append_fragment(libj, "%s", json->boolean ? "true" : "false"));
+        err = json->boolean ? E(write_bytes(writer, "true", 4)) : E(write_bytes(writer, "false", 5));
         break;
     case LIBJ_TYPE_ARRAY:
-        err = E(append_array(libj, json));
+        err = E(write_array(writer, json));
         break;
     case LIBJ_TYPE_OBJECT:
-        err = E(append_object(libj, json));
+        err = E(write_object(writer, json));
         break;
     default:
         abort();
@@ -318,6 +425,38 @@ end:
     return err;
 }
 
+/* Make writer format json according to options. */
+static LibjError writer_setup(Writer *writer, LibjToStringOptions *options) {
+    LibjError err = LIBJ_ERROR_OK;
+    if (!writer || !options || !options->indent_string) {
+        err = LIBJ_ERROR_BAD_ARGUMENT;
+        goto end;
+    }
+    writer->ascii_only = options->ascii_only;
+    writer->indent = options->indent_string;
+    writer->indent_size = strlen(options->indent_string);
+    err = compose_fragments(writer, options);
+    if (err) goto end;
+end:
+    return err;
+}
+
+/* Write json formatted according to options. */
+static LibjError serialize(Writer *writer, LibjJson *json, LibjToStringOptions *options) {
+    LibjError err = LIBJ_ERROR_OK;
+    if (!writer || !json || !options) {
+        err = LIBJ_ERROR_BAD_ARGUMENT;
+        goto end;
+    }
+    err = writer_setup(writer, options);
+    if (err) goto end;
+    err = E(write_json(writer, json));
+    if (err) goto end;
+    assert(!writer->depth);
+end:
+    return err;
+}
+
 LibjError libj_to_string(Libj *libj, LibjJson *json, char **json_string, LibjToStringOptions *options) {
     size_t json_string_size;
     return libj_to_string_ex(libj, json, json_string, &json_string_size, options);
@@ -326,25 +465,147 @@ LibjError libj_to_string(Libj *libj, LibjJson *json, char **json_string, LibjToS
 LibjError libj_to_string_ex(Libj *libj, LibjJson *json, char **json_string, size_t *json_string_size,
                             LibjToStringOptions *options) {
     LibjError err = LIBJ_ERROR_OK;
+    Writer writer = { 0 };
     if (!libj || !json || !json_string || !json_string_size || !options) {
         err = LIBJ_ERROR_BAD_ARGUMENT;
         goto end;
     }
-    err = ESB(libsb_create(libj->libsb, &libj->builder));
+    err = serialize(&writer, json, options);
     if (err) goto end;
-    libj->to_string_options = options;
-    libj->depth = 0;
-    err = E(append_json(libj, json));
+    err = E(write_bytes(&writer, "", 1));
     if (err) goto end;
-    assert(!libj->depth);
-    ESB(libsb_destroy_into(libj->libsb, &libj->builder, json_string, json_string_size));
-    libj->builder = NULL;
+    *json_string = writer.data;
+    *json_string_size = writer.size - 1;
+    writer.data = NULL;
 end:
-    if (libj) {
-        libj->depth = 0;
-        libj->to_string_options = NULL;
-        ESB(libsb_destroy(libj->libsb, &libj->builder));
+    free(writer.data);
+    free(writer.fragments_text);
+    return err;
+}
+
+LibjError libj_to_writer(Libj *libj, LibjJson *json, LibjWriteCallback write, void *user,
+                         LibjToStringOptions *options) {
+    LibjError err = LIBJ_ERROR_OK;
+    Writer writer = { 0 };
+    if (!libj || !json || !write || !options) {
+        err = LIBJ_ERROR_BAD_ARGUMENT;
+        goto end;
+    }
+    writer.write = write;
+    writer.user = user;
+    writer.data = malloc(CHUNK_SIZE);
+    if (!writer.data) {
+        err = LIBJ_ERROR_OUT_OF_MEMORY;
+        goto end;
     }
+    writer.capacity = CHUNK_SIZE;
+    err = serialize(&writer, json, options);
+    if (err) goto end;
+    err = E(flush(&writer));
+    if (err) goto end;
+end:
+    free(writer.data);
+    free(writer.fragments_text);
     return err;
 }
 
+static bool write_to_fd(void *user, const char *bytes, size_t size) {
+    int fd = *(int *) user;
+    while (size) {
+        ssize_t written = write(fd, bytes, size);
+        if (written < 0 && EINTR == errno) {
+            continue;
+        }
+        if (written <= 0) {
+            return false;
+        }
+        bytes += written;
+        size -= written;
+    }
+    return true;
+}
+
+LibjError libj_to_fd(Libj *libj, LibjJson *json, int fd, LibjToStringOptions *options) {
+    return libj_to_writer(libj, json, write_to_fd, &fd, options);
+}
+
+/* Compact records are collected in one chunk for all of them and passed to the write callback when it's full. */
+struct LibjNdjsonWriter_ {
+    Writer writer;
+};
+
+LibjError libj_ndjson_writer_create(Libj *libj, LibjWriteCallback write, void *user, LibjNdjsonWriter **writer) {
+    LibjError err = LIBJ_ERROR_OK;
+    LibjNdjsonWriter *result = NULL;
+    if (!libj || !write || !writer) {
+        err = LIBJ_ERROR_BAD_ARGUMENT;
+        goto end;
+    }
+    result = calloc(1, sizeof(LibjNdjsonWriter));
+    if (!result) {
+        err = LIBJ_ERROR_OUT_OF_MEMORY;
+        goto end;
+    }
+    result->writer.write = write;
+    result->writer.user = user;
+    result->writer.data = malloc(CHUNK_SIZE);
+    if (!result->writer.data) {
+        err = LIBJ_ERROR_OUT_OF_MEMORY;
+        goto end;
+    }
+    result->writer.capacity = CHUNK_SIZE;
+    err = writer_setup(&result->writer, &libj_to_string_options_compact);
+    if (err) goto end;
+    *writer = result;
+    result = NULL;
+end:
+    if (result) {
+        free(result->writer.data);
+        free(result->writer.fragments_text);
+    }
+    free(result);
+    return err;
+}
+
+LibjError libj_ndjson_writer_free(Libj *libj, LibjNdjsonWriter **writer) {
+    LibjError err = LIBJ_ERROR_OK;
+    if (!libj || !writer) {
+        err = LIBJ_ERROR_BAD_ARGUMENT;
+        goto end;
+    }
+    if (*writer) {
+        free((*writer)->writer.data);
+        free((*writer)->writer.fragments_text);
+    }
+    free(*writer);
+    *writer = NULL;
+end:
+    return err;
+}
+
+LibjError libj_ndjson_write(Libj *libj, LibjNdjsonWriter *writer, LibjJson *json) {
+    LibjError err = LIBJ_ERROR_OK;
+    if (!libj || !writer || !json) {
+        err = LIBJ_ERROR_BAD_ARGUMENT;
+        goto end;
+    }
+    /* Compact json has no newlines, strings have them escaped. */
+    err = E(write_json(&writer->writer, json));
+    if (err) goto end;
+    err = E(write_bytes(&writer->writer, "\n", 1));
+    if (err) goto end;
+end:
+    return err;
+}
+
+LibjError libj_ndjson_writer_flush(Libj *libj, LibjNdjsonWriter *writer) {
+    LibjError err = LIBJ_ERROR_OK;
+    if (!libj || !writer) {
+        err = LIBJ_ERROR_BAD_ARGUMENT;
+        goto end;
+    }
+    err = E(flush(&writer->writer));
+    if (err) goto end;
+end:
+    return err;
+}
@@ -1,14 +1,15 @@
 #include "libj_utils.h"
+#include "libj_simd.h"
 
 #include <string.h>
 
-LibjError libj_string_duplicate(Libj *libj, const char *src, size_t size, char **dst) {
+LibjError libj_string_duplicate(Libj *libj, LibjDocument *document, const char *src, size_t size, char **dst) {
     LibjError err = LIBJ_ERROR_OK;
     if (!libj || !src || !dst) {
         err = LIBJ_ERROR_BAD_ARGUMENT;
         goto end;
     }
-    *dst = malloc(size + 1);
+    *dst = libj_allocate(document, size + 1);
     if (!*dst) {
         err = LIBJ_ERROR_OUT_OF_MEMORY;
         goto end;
@@ -23,16 +24,19 @@ static bool is_space(char c) {
     return c && strchr("\x20\x09\x0A\x0D", c);
 }
 
-LibjError libj_skip_whitespace(Libj *libj, LibisInputStream *input, bool *eof, char *c) {
+LibjError libj_skip_whitespace(Libj *libj, LibjInput *input, bool *eof, char *c) {
     LibjError err = LIBJ_ERROR_OK;
     if (!libj || !input || !eof || !c) {
         err = LIBJ_ERROR_BAD_ARGUMENT;
         goto end;
     }
-    err = EIS(libis_lookahead(libj->libis, input, eof, 1, c));
+    if (!input->stream && !input->lines) {
+        input->current += libj_simd_skip_whitespace(input->current, input->end);
+    }
+    err = libj_input_lookahead(libj, input, eof, c);
     if (err) goto end;
-    while (is_space(*c)) {
-        err = EIS(libis_skip_char(libj->libis, input, eof, c));
+    while (is_space(*c) && !(input->lines && '\n' == *c)) {
+        err = libj_input_skip_char(libj, input, eof, c);
         if (err) goto end;
     }
 end:
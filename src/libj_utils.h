@@ -3,12 +3,60 @@
 
 #include "libj_internal.h"
 
-LibjError libj_string_duplicate(Libj *libj, const char *src, size_t size, char **dst);
+#include <stdio.h>
 
-// Keep discarding characters from input as long is it's json whitespace characters.
+/* Copy size bytes of src into null-terminated string allocated from document. */
+LibjError libj_string_duplicate(Libj *libj, LibjDocument *document, const char *src, size_t size, char **dst);
+
+static inline void libj_input_from_stream(LibjInput *input, LibisInputStream *stream) {
+    input->stream = stream;
+    input->current = NULL;
+    input->end = NULL;
+    input->strings = LIBJ_STRING_OWNED;
+    input->position = 0;
+    input->lines = false;
+}
+
+static inline void libj_input_from_buffer(LibjInput *input, const char *buffer, size_t size) {
+    input->stream = NULL;
+    input->current = buffer;
+    input->end = buffer + size;
+    input->strings = LIBJ_STRING_OWNED;
+    input->position = 0;
+    input->lines = false;
+}
+
+// Read next character of input without consuming it.
+// eof -- output parameter, whether end of file was reached
+// c   -- output parameter, next character or EOF
+static inline LibjError libj_input_lookahead(Libj *libj, LibjInput *input, bool *eof, char *c) {
+    if (input->stream) {
+        return EIS(libis_lookahead(libj->libis, input->stream, eof, 1, c));
+    }
+    *eof = input->current == input->end;
+    *c = *eof ? (char) EOF : *input->current;
+    return LIBJ_ERROR_OK;
+}
+
+// Consume next character of input and read the one after it. Parameters are the same as in libj_input_lookahead().
+static inline LibjError libj_input_skip_char(Libj *libj, LibjInput *input, bool *eof, char *c) {
+    if (input->stream) {
+        ++input->position;
+        return EIS(libis_skip_char(libj->libis, input->stream, eof, c));
+    }
+    if (input->current != input->end) {
+        ++input->current;
+    }
+    *eof = input->current == input->end;
+    *c = *eof ? (char) EOF : *input->current;
+    return LIBJ_ERROR_OK;
+}
+
+// Keep discarding characters from input as long is it's json whitespace characters. In lines mode a newline
+// stops it.
 // eof -- output parameter, whether end of file was reached
 // c   -- output parameter, next character after whitespaces
-LibjError libj_skip_whitespace(Libj *libj, LibisInputStream *input, bool *eof, char *c);
+LibjError libj_skip_whitespace(Libj *libj, LibjInput *input, bool *eof, char *c);
 
 #endif
 
@@ -13,12 +13,70 @@ static Libj *libj;
 static int number_of_tests;
 static int number_of_tests_passed;
 
+typedef enum {
+    PATH_BUFFER,
+    PATH_INSITU,
+    PATH_VIEW,
+} Path;
+
+/* Parsing from a buffer takes a different path than parsing from an input stream and parsing in-situ or into
+ * views take yet other ones. All of them have to agree on every input. */
+static bool path_agrees(Path path, const char *json_string, size_t json_string_size,
+                        LibjError stream_err, const char *stream_error_string, LibjJson *stream_json) {
+    LibjJson *json = NULL;
+    const char *error_string = NULL;
+    char *stream_text = NULL;
+    char *buffer_text = NULL;
+    char *buffer = NULL;
+    bool agrees = false;
+    LibjError err_j;
+    switch (path) {
+    case PATH_BUFFER:
+        err_j = libj_from_string_ex(libj, &json, json_string, json_string_size, &error_string);
+        break;
+    case PATH_INSITU:
+        buffer = malloc(json_string_size + 1);
+        if (!buffer) {
+            goto end;
+        }
+        memcpy(buffer, json_string, json_string_size);
+        err_j = libj_from_buffer_insitu(libj, &json, buffer, json_string_size, &error_string);
+        break;
+    case PATH_VIEW:
+        err_j = libj_from_buffer_view(libj, &json, json_string, json_string_size, &error_string);
+        break;
+    default:
+        goto end;
+    }
+    if (err_j != stream_err) {
+        goto end;
+    }
+    if (err_j) {
+        agrees = !strcmp(error_string, stream_error_string);
+        goto end;
+    }
+    if (libj_to_string(libj, stream_json, &stream_text, &libj_to_string_options_compact)) {
+        goto end;
+    }
+    if (libj_to_string(libj, json, &buffer_text, &libj_to_string_options_compact)) {
+        goto end;
+    }
+    agrees = !strcmp(stream_text, buffer_text);
+end:
+    free(stream_text);
+    free(buffer_text);
+    libj_free_json(libj, &json);
+    free(buffer);
+    return agrees;
+}
+
 static void run_test(const char *path, bool should_parse, const char *json_string, size_t json_string_size) {
     LibisSource *source = NULL;
     LibisInputStream *input = NULL;
     LibjJson *json = NULL;
     bool success = true;
     const char *error_string = NULL;
+    char *stream_error_string = NULL;
     char c;
     bool eof;
     LibisError err_is = libis_source_create_from_buffer(libis, &source, json_string, json_string_size, false);
@@ -32,6 +90,17 @@ static void run_test(const char *path, bool should_parse, const char *json_strin
         goto end;
     }
     LibjError err_j = libj_from_input_stream(libj, &json, input, &error_string);
+    stream_error_string = strdup(error_string ? error_string : "");
+    if (!stream_error_string) {
+        success = false;
+        goto end;
+    }
+    if (!path_agrees(PATH_BUFFER, json_string, json_string_size, err_j, stream_error_string, json) ||
+        !path_agrees(PATH_INSITU, json_string, json_string_size, err_j, stream_error_string, json) ||
+        !path_agrees(PATH_VIEW, json_string, json_string_size, err_j, stream_error_string, json)) {
+        success = false;
+        goto end;
+    }
     err_is = libis_lookahead(libis, input, &eof, 1, &c);
     if (err_is) {
         success = false;
@@ -46,7 +115,7 @@ static void run_test(const char *path, bool should_parse, const char *json_strin
     }
     bool is_parsed = err_j == LIBJ_ERROR_OK;
     bool is_parsed_completely = is_parsed && eof;
-    bool has_error_message = error_string && strcmp(error_string, "");
+    bool has_error_message = strcmp(stream_error_string, "");
     if (!is_parsed && !has_error_message) {
         success = false;
         goto end;
@@ -56,6 +125,7 @@ static void run_test(const char *path, bool should_parse, const char *json_strin
         goto end;
     }
 end:
+    free(stream_error_string);
     libj_free_json(libj, &json);
     libis_source_destroy(libis, &source);
     libis_destroy(libis, &input);
@@ -0,0 +1,360 @@
+#include "test.h"
+
+/* From libj_internal.h, which can't be included next to test.h. */
+size_t libj_document_size(LibjDocument *document);
+
+static void take_check(void) {
+    LibjJson *object = NULL;
+    LibjJson *array = NULL;
+    LibjJson *element = NULL;
+    LibjJson *found = NULL;
+    size_t size;
+    int64_t integer;
+
+    E(libj_array_create(libj, &array));
+    E(libj_integer_create(libj, &element, 42));
+    LibjJson *taken = element;
+    E(libj_array_add_take(libj, array, &element));
+    assert(!element);
+    E(libj_array_get_element_at(libj, array, 0, &found));
+    assert(found == taken);
+
+    E(libj_object_create(libj, &object));
+    E(libj_object_add_take(libj, object, "array", &array));
+    assert(!array);
+    E(libj_integer_create(libj, &element, 13));
+    E(libj_object_insert_at_take_ex(libj, object, 0, "first", 5, &element));
+    assert(!element);
+    E(libj_object_get_size(libj, object, &size));
+    assert(2 == size);
+    E(libj_object_get_integer(libj, object, &integer, "first"));
+    assert(13 == integer);
+
+    E(libj_integer_create(libj, &element, 7));
+    CHECK(LIBJ_ERROR_NOT_FOUND == libj_object_insert_at_take_ex(libj, object, 3, "x", 1, &element));
+    assert(element);
+    E(libj_free_json(libj, &element));
+
+    E(libj_free_json(libj, &object));
+}
+
+static void capacity_check(void) {
+    LibjJson *array = NULL;
+    LibjJson *object = NULL;
+    LibjJson *element = NULL;
+    size_t size;
+    int64_t integer;
+
+    E(libj_array_create(libj, &array));
+    E(libj_array_reserve(libj, array, 1000));
+    for (int i = 0; i < 1000; ++i) {
+        E(libj_array_add_integer(libj, array, i));
+    }
+    for (int i = 0; i < 500; ++i) {
+        E(libj_array_remove_at(libj, array, 0));
+    }
+    E(libj_shrink_to_fit(libj, array));
+    E(libj_array_get_size(libj, array, &size));
+    assert(500 == size);
+    E(libj_array_get_element_at(libj, array, 0, &element));
+    E(libj_get_integer(libj, element, &integer));
+    assert(500 == integer);
+    while (size--) {
+        E(libj_array_remove_at(libj, array, size));
+    }
+    E(libj_shrink_to_fit(libj, array));
+    E(libj_array_add_null(libj, array));
+
+    E(libj_object_create(libj, &object));
+    E(libj_object_reserve(libj, object, 3));
+    E(libj_object_add_integer(libj, object, "a", 1));
+    E(libj_object_add_integer(libj, object, "b", 2));
+    E(libj_object_remove_at(libj, object, 0));
+    E(libj_shrink_to_fit(libj, object));
+    E(libj_object_get_integer(libj, object, &integer, "b"));
+    assert(2 == integer);
+    CHECK(LIBJ_ERROR_BAD_TYPE == libj_array_reserve(libj, object, 10));
+    E(libj_object_add_take(libj, object, "array", &array));
+
+    E(libj_null_create(libj, &element));
+    CHECK(LIBJ_ERROR_BAD_TYPE == libj_shrink_to_fit(libj, element));
+    E(libj_free_json(libj, &element));
+
+    E(libj_free_json(libj, &object));
+}
+
+/* Lookups have to give the same answers whether object is searched linearly or through its index. */
+static void versions_check(void) {
+    LibjJson *object = NULL;
+    LibjJson *value = NULL;
+    char name[32];
+    size_t nversions;
+    int64_t integer;
+
+    E(libj_object_create(libj, &object));
+    for (int i = 0; i < 1000; ++i) {
+        snprintf(name, sizeof(name), "key%d", i % 300);
+        E(libj_object_add_integer(libj, object, name, i));
+    }
+    for (int round = 0; round < 2; ++round) {
+        for (int i = 0; i < 300; ++i) {
+            snprintf(name, sizeof(name), "key%d", i);
+            E(libj_object_count_versions(libj, object, name, &nversions));
+            assert((i < 100 ? 4u : 3u) == nversions);
+            for (size_t version = 0; version < nversions; ++version) {
+                E(libj_object_get_version(libj, object, &value, name, version));
+                E(libj_get_integer(libj, value, &integer));
+                assert(i + 300 * (int64_t) version == integer);
+            }
+            CHECK(LIBJ_ERROR_NOT_FOUND == libj_object_get_version(libj, object, &value, name, nversions));
+            E(libj_object_get_integer(libj, object, &integer, name));
+            assert(i + 300 * (int64_t) (nversions - 1) == integer);
+        }
+        E(libj_object_count_versions(libj, object, "missing", &nversions));
+        assert(0 == nversions);
+        CHECK(LIBJ_ERROR_NOT_FOUND == libj_object_get_integer(libj, object, &integer, "missing"));
+        /* Moving members around must not leave stale positions behind. */
+        E(libj_integer_create(libj, &value, -1));
+        E(libj_object_insert_at_take_ex(libj, object, 0, "front", 5, &value));
+        E(libj_object_remove_at(libj, object, 0));
+    }
+    E(libj_object_get_size(libj, object, &nversions));
+    assert(1000 == nversions);
+    CHECK(LIBJ_ERROR_NOT_FOUND == libj_object_remove(libj, object, "missing"));
+    E(libj_object_get_size(libj, object, &nversions));
+    assert(1000 == nversions);
+    E(libj_free_json(libj, &object));
+}
+
+/* Index of an object from a document is rebuilt in place after members are removed. */
+static void document_index_check(void) {
+    LibjDocument *document = NULL;
+    LibjJson *object = NULL;
+    char name[32];
+    int64_t integer;
+    size_t size_before;
+    size_t size_after;
+
+    E(libj_document_create(libj, &document));
+    E(libj_use_document(libj, document));
+    E(libj_object_create(libj, &object));
+    for (int i = 0; i < 1000; ++i) {
+        snprintf(name, sizeof(name), "key%d", i);
+        E(libj_object_add_integer(libj, object, name, i));
+    }
+    E(libj_object_get_integer(libj, object, &integer, "key0"));
+    size_before = libj_document_size(document);
+    for (int i = 0; i < 500; ++i) {
+        E(libj_object_remove_at(libj, object, 0));
+        snprintf(name, sizeof(name), "key%d", i + 1);
+        E(libj_object_get_integer(libj, object, &integer, name));
+        assert(i + 1 == integer);
+    }
+    size_after = libj_document_size(document);
+    assert(size_before == size_after);
+    E(libj_use_document(libj, NULL));
+    E(libj_document_free(libj, &document));
+}
+
+/* Removing members anywhere keeps versions of the remaining ones in order. */
+static void remove_check(void) {
+    LibjJson *object = NULL;
+    LibjJson *value = NULL;
+    int64_t values[200];
+    size_t size = sizeof(values) / sizeof(values[0]);
+    char name[32];
+    size_t nversions;
+    int64_t integer;
+    unsigned seed = 1;
+
+    E(libj_object_create(libj, &object));
+    for (size_t i = 0; i < size; ++i) {
+        snprintf(name, sizeof(name), "key%zu", i % 50);
+        values[i] = (int64_t) i;
+        E(libj_object_add_integer(libj, object, name, values[i]));
+    }
+    while (size) {
+        seed = seed * 1103515245 + 12345;
+        size_t position = (seed >> 16) % size;
+        E(libj_object_remove_at(libj, object, position));
+        memmove(&values[position], &values[position + 1], sizeof(values[0]) * (size - position - 1));
+        --size;
+        for (int key = 0; key < 50; ++key) {
+            snprintf(name, sizeof(name), "key%d", key);
+            size_t version = 0;
+            for (size_t i = 0; i < size; ++i) {
+                if (key != values[i] % 50) {
+                    continue;
+                }
+                E(libj_object_get_version(libj, object, &value, name, version++));
+                E(libj_get_integer(libj, value, &integer));
+                assert(values[i] == integer);
+            }
+            E(libj_object_count_versions(libj, object, name, &nversions));
+            assert(version == nversions);
+        }
+    }
+    E(libj_free_json(libj, &object));
+}
+
+static void set_check(void) {
+    LibjJson *object = NULL;
+    const char *error_string = NULL;
+    char *output = NULL;
+    E(libj_from_string(libj, &object, "{\"a\": 1, \"b\": 2, \"b\": 3, \"b\": 4, \"c\": 5, \"b\": 6}", &error_string));
+    E(libj_object_set_integer(libj, object, "b", 7));
+    E(libj_object_set_bool(libj, object, "a", true));
+    E(libj_object_set_null(libj, object, "d"));
+    E(libj_object_set_real(libj, object, "e", 0.5));
+    E(libj_to_string(libj, object, &output, &libj_to_string_options_compact));
+    assert(!strcmp("{\"a\":true,\"c\":5,\"b\":7,\"d\":null,\"e\":0.5}", output));
+    free(output);
+    E(libj_free_json(libj, &object));
+
+    E(libj_from_string(libj, &object, "{\"x\": 1, \"x\": 2, \"y\": 3, \"x\": 4, \"x\": 5}", &error_string));
+    E(libj_object_remove_all_ex(libj, object, "x", 1));
+    E(libj_to_string(libj, object, &output, &libj_to_string_options_compact));
+    assert(!strcmp("{\"y\":3}", output));
+    free(output);
+    E(libj_free_json(libj, &object));
+
+    E(libj_integer_create(libj, &object, 1));
+    CHECK(LIBJ_ERROR_BAD_TYPE == libj_object_set_integer(libj, object, "a", 1));
+    E(libj_free_json(libj, &object));
+}
+
+static void interning_check(void) {
+    LibjJson *array = NULL;
+    LibjJson *object = NULL;
+    LibjJson *value = NULL;
+    const char *error_string = NULL;
+    const char *name = NULL;
+    const char *other_name = NULL;
+    const char *new_name = NULL;
+    const char *other_new_name = NULL;
+    size_t name_size = 0;
+    const LibjSymbol *id = NULL;
+    const LibjSymbol *other = NULL;
+    int64_t integer = 0;
+    E(libj_use_interning(libj, true));
+    E(libj_from_string(libj, &array, "[{\"id\": 1, \"x\": 2}, {\"x\": 3, \"id\": 4, \"id\": 5}]", &error_string));
+    E(libj_intern(libj, "id", 2, &id));
+    E(libj_intern(libj, "id", 2, &other));
+    assert(id == other);
+    E(libj_intern(libj, "missing", 7, &other));
+    assert(id != other);
+    E(libj_array_get_element_at(libj, array, 0, &object));
+    E(libj_object_get_member_at_ex(libj, object, 0, &name, &name_size, &value));
+    E(libj_object_get_symbol(libj, object, id, &value));
+    E(libj_get_integer(libj, value, &integer));
+    assert(1 == integer);
+    CHECK(LIBJ_ERROR_NOT_FOUND == libj_object_get_symbol(libj, object, other, &value));
+    E(libj_array_get_element_at(libj, array, 1, &object));
+    E(libj_object_get_member_at_ex(libj, object, 1, &other_name, &name_size, &value));
+    assert(name == other_name);
+    E(libj_object_get_symbol(libj, object, id, &value));
+    E(libj_get_integer(libj, value, &integer));
+    assert(5 == integer);
+    E(libj_free_json(libj, &array));
+
+    /* Names added by hand share symbols too and are found through the index of big objects. */
+    E(libj_object_create(libj, &object));
+    for (int i = 0; i < 40; ++i) {
+        char key[16];
+        snprintf(key, sizeof(key), "key%d", i);
+        E(libj_object_set_integer(libj, object, key, i));
+    }
+    E(libj_object_set_integer(libj, object, "id", 42));
+    E(libj_copy(libj, object, &array));
+    E(libj_object_get_symbol(libj, array, id, &value));
+    E(libj_get_integer(libj, value, &integer));
+    assert(42 == integer);
+    CHECK(LIBJ_ERROR_NOT_FOUND == libj_object_get_symbol(libj, array, other, &value));
+    E(libj_object_remove(libj, array, "id"));
+    CHECK(LIBJ_ERROR_NOT_FOUND == libj_object_get_symbol(libj, array, id, &value));
+    E(libj_free_json(libj, &array));
+    E(libj_free_json(libj, &object));
+
+    /* Once the symbol table is full new names are copied but names interned already are still shared. */
+    E(libj_object_create(libj, &object));
+    for (int i = 0; i < 1 << 16; ++i) {
+        char key[16];
+        snprintf(key, sizeof(key), "name%d", i);
+        E(libj_object_add_integer(libj, object, key, i));
+    }
+    E(libj_free_json(libj, &object));
+    E(libj_from_string(libj, &array, "[{\"id\": 1, \"new\": 2}, {\"id\": 3, \"new\": 4}]", &error_string));
+    E(libj_array_get_element_at(libj, array, 0, &object));
+    E(libj_object_get_member_at_ex(libj, object, 0, &name, &name_size, &value));
+    E(libj_object_get_member_at_ex(libj, object, 1, &new_name, &name_size, &value));
+    E(libj_array_get_element_at(libj, array, 1, &object));
+    E(libj_object_get_member_at_ex(libj, object, 0, &other_name, &name_size, &value));
+    E(libj_object_get_member_at_ex(libj, object, 1, &other_new_name, &name_size, &value));
+    assert(name == other_name);
+    assert(new_name != other_new_name && !strcmp(new_name, other_new_name));
+    E(libj_free_json(libj, &array));
+    E(libj_use_interning(libj, false));
+
+    /* Names that are not interned are still found by symbol. */
+    E(libj_from_string(libj, &object, "{\"id\": 7}", &error_string));
+    E(libj_object_get_symbol(libj, object, id, &value));
+    E(libj_get_integer(libj, value, &integer));
+    assert(7 == integer);
+    E(libj_free_json(libj, &object));
+}
+
+static void path_check(void) {
+    LibjJson *array = NULL;
+    LibjJson *object = NULL;
+    LibjJson *value = NULL;
+    const char *error_string = NULL;
+    LibjPath *id = NULL;
+    LibjPath *name = NULL;
+    LibjPath *empty = NULL;
+    int64_t integer = 0;
+    char *string = NULL;
+    bool boolean = false;
+    E(libj_path_compile(libj, &id, "user", "id"));
+    E(libj_path_compile(libj, &name, "user", "name", NULL));
+    E(libj_path_compile(libj, &empty, ""));
+    E(libj_from_string(libj, &array,
+            "[{\"user\": {\"id\": 1, \"name\": \"a\"}},"
+            " {\"user\": {\"name\": \"b\", \"id\": 2, \"id\": 3}, \"\": true},"
+            " {\"user\": 4}, {\"users\": {}}, {\"user\": {\"id\": \"5\"}}]", &error_string));
+    E(libj_array_get_element_at(libj, array, 0, &object));
+    E(libj_path_get_integer(libj, object, id, &integer));
+    assert(1 == integer);
+    E(libj_path_get_string(libj, object, name, &string));
+    assert(!strcmp("a", string));
+    CHECK(LIBJ_ERROR_NOT_FOUND == libj_path_get(libj, object, empty, &value));
+    E(libj_array_get_element_at(libj, array, 1, &object));
+    E(libj_path_get_integer(libj, object, id, &integer));
+    assert(3 == integer);
+    E(libj_path_get_string(libj, object, name, &string));
+    assert(!strcmp("b", string));
+    E(libj_path_get_bool(libj, object, empty, &boolean));
+    assert(boolean);
+    E(libj_array_get_element_at(libj, array, 2, &object));
+    CHECK(LIBJ_ERROR_BAD_TYPE == libj_path_get_integer(libj, object, id, &integer));
+    E(libj_array_get_element_at(libj, array, 3, &object));
+    CHECK(LIBJ_ERROR_NOT_FOUND == libj_path_get_integer(libj, object, id, &integer));
+    E(libj_array_get_element_at(libj, array, 4, &object));
+    CHECK(LIBJ_ERROR_BAD_TYPE == libj_path_get_integer(libj, object, id, &integer));
+    CHECK(LIBJ_ERROR_BAD_TYPE == libj_path_get(libj, array, id, &value));
+    E(libj_free_json(libj, &array));
+    E(libj_path_free(libj, &id));
+    E(libj_path_free(libj, &name));
+    E(libj_path_free(libj, &empty));
+    E(libj_path_free(libj, &empty));
+}
+
+void containers_check(void) {
+    take_check();
+    capacity_check();
+    versions_check();
+    document_index_check();
+    remove_check();
+    set_check();
+    interning_check();
+    path_check();
+}
@@ -0,0 +1,41 @@
+#include "test.h"
+
+void document_check(void) {
+    LibjDocument *document = NULL;
+    LibjJson *json = NULL;
+    LibjJson *array = NULL;
+    LibjJson *heap_value = NULL;
+    LibjJson *copy = NULL;
+    const char *error_string;
+    char *string;
+    int64_t integer;
+
+    E(libj_document_create(libj, &document));
+    E(libj_use_document(libj, document));
+    E(libj_from_string(libj, &json, "{\"a\": [1, 2, {\"b\": \"c\"}], \"d\": -1.5e3}", &error_string));
+    E(libj_object_get(libj, json, &array, "a"));
+    for (int i = 0; i < 10000; ++i) {
+        E(libj_array_add_integer(libj, array, i));
+    }
+    E(libj_object_add_string(libj, json, "e", "f"));
+    E(libj_object_remove_at(libj, json, 0));
+    E(libj_use_document(libj, NULL));
+
+    /* Values from the heap are copied into the document when added to its containers. */
+    E(libj_integer_create(libj, &heap_value, 42));
+    E(libj_object_add_take(libj, json, "g", &heap_value));
+    assert(!heap_value);
+    E(libj_object_get_integer(libj, json, &integer, "g"));
+    assert(42 == integer);
+
+    E(libj_copy(libj, json, &copy));
+    E(libj_to_string(libj, copy, &string, &libj_to_string_options_compact));
+    assert(!strcmp("{\"d\":-1.5e3,\"e\":\"f\",\"g\":42}", string));
+    free(string);
+
+    E(libj_free_json(libj, &json));
+    assert(!json);
+    E(libj_document_free(libj, &document));
+    E(libj_document_free(libj, &document));
+    E(libj_free_json(libj, &copy));
+}
@@ -6,11 +6,16 @@ Libj *libj;
 int main() {
     E(libj_start(&libj));
     sanity_check();
+    containers_check();
+    document_check();
+    parser_check();
+    serializer_check();
     if (setlocale(LC_NUMERIC, "C")) {
         sanity_check();
     }
     if (setlocale(LC_NUMERIC, "ru_RU")) {
         sanity_check();
+        parser_check();
     }
     E(libj_finish(&libj));
 }
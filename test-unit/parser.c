@@ -0,0 +1,624 @@
+#include "test.h"
+
+/* Whitespace runs of every length around the vector widths, made of all four whitespace characters. */
+static void whitespace_check(void) {
+    static const char whitespace[] = " \t\n\r";
+    char input[1024];
+    for (size_t n = 0; n < 80; ++n) {
+        char run[100];
+        for (size_t i = 0; i < n; ++i) {
+            run[i] = whitespace[(i * 7 + n) % 4];
+        }
+        run[n] = '\0';
+        int size = snprintf(input, sizeof(input), "%s{%s\"a\"%s:%s[%s1%s,%strue%s]%s}%s",
+                            run, run, run, run, run, run, run, run, run, run);
+        assert(0 < size && (size_t) size < sizeof(input));
+        LibjJson *json = NULL;
+        const char *error_string = NULL;
+        char *output = NULL;
+        E(libj_from_string_ex(libj, &json, input, size, &error_string));
+        E(libj_to_string(libj, json, &output, &libj_to_string_options_compact));
+        assert(!strcmp("{\"a\":[1,true]}", output));
+        free(output);
+        E(libj_free_json(libj, &json));
+    }
+}
+
+/* Long string values with escapes and multibyte characters at every offset relative to the vector widths. */
+static void string_check(void) {
+    static const char *pieces[] = {
+        "a", "\\u00e9", "\\ud83d\\ude00", "\\n", "\xc3\xa9", "\xe2\x82\xac", "\xf0\x9f\x98\x80"
+    };
+    static const char *values[] = {
+        "a", "\xc3\xa9", "\xf0\x9f\x98\x80", "\n", "\xc3\xa9", "\xe2\x82\xac", "\xf0\x9f\x98\x80"
+    };
+    char input[1024];
+    char expected[1024];
+    for (size_t piece = 0; piece < sizeof(pieces) / sizeof(pieces[0]); ++piece) {
+        for (size_t n = 0; n < 70; ++n) {
+            size_t input_size = 0;
+            size_t expected_size = 0;
+            input[input_size++] = '"';
+            for (size_t i = 0; i < n; ++i) {
+                input[input_size++] = 'x';
+                expected[expected_size++] = 'x';
+            }
+            for (int repeat = 0; repeat < 3; ++repeat) {
+                memcpy(input + input_size, pieces[piece], strlen(pieces[piece]));
+                input_size += strlen(pieces[piece]);
+                memcpy(expected + expected_size, values[piece], strlen(values[piece]));
+                expected_size += strlen(values[piece]);
+                for (size_t i = 0; i < 17; ++i) {
+                    input[input_size++] = 'y';
+                    expected[expected_size++] = 'y';
+                }
+            }
+            input[input_size++] = '"';
+            LibjJson *json = NULL;
+            const char *error_string = NULL;
+            char *value = NULL;
+            size_t value_size = 0;
+            E(libj_from_string_ex(libj, &json, input, input_size, &error_string));
+            E(libj_get_string_ex(libj, json, &value, &value_size));
+            assert(expected_size == value_size);
+            assert(!memcmp(expected, value, value_size));
+            E(libj_free_json(libj, &json));
+        }
+    }
+}
+
+static void expect_syntax_error(const char *input, size_t input_size, const char *expected_error_string) {
+    LibjJson *json = NULL;
+    const char *error_string = NULL;
+    CHECK(LIBJ_ERROR_SYNTAX == libj_from_string_ex(libj, &json, input, input_size, &error_string));
+    assert(!json);
+    assert(!strcmp(expected_error_string, error_string));
+}
+
+static void bad_string_check(void) {
+    static const char truncated[] = "\"0123456789abcdefghijklmnopqrstuvwxyz\xe2\x82\"";
+    static const char overlong[] = "\"0123456789abcdefghijklmnopqrstuvwxyz\xc0\xaf" "0123456789\"";
+    static const char control[] = "\"0123456789abcdefghijklmnopqrstuvwxyz\x01\"";
+    static const char null[] = "\"0123456789abcdefghijklmnopqrstuvwxyz\0\"";
+    static const char unterminated[] = "\"0123456789abcdefghijklmnopqrstuvwxyz";
+    expect_syntax_error(truncated, sizeof(truncated) - 1, "input is not UTF-8");
+    expect_syntax_error(overlong, sizeof(overlong) - 1, "input is not UTF-8");
+    expect_syntax_error(control, sizeof(control) - 1, "control character is not escaped");
+    expect_syntax_error(null, sizeof(null) - 1, "null character is not escaped");
+    expect_syntax_error(unterminated, sizeof(unterminated) - 1, "unexpected end of file");
+}
+
+static void insitu_check(void) {
+    char buffer[] = "{\"name\": \"plain\", \"escaped\\u00e9\": \"a\\\"b\\n\\ud83d\\ude00\", \"number\": 12.5}";
+    LibjJson *json = NULL;
+    LibjJson *copy = NULL;
+    const char *error_string = NULL;
+    char *value = NULL;
+    size_t value_size = 0;
+    double real;
+    E(libj_from_buffer_insitu(libj, &json, buffer, sizeof(buffer) - 1, &error_string));
+    E(libj_object_get_string(libj, json, &value, "name"));
+    assert(!strcmp("plain", value));
+    assert(buffer <= value && value < buffer + sizeof(buffer));
+    LibjJson *escaped = NULL;
+    E(libj_object_get(libj, json, &escaped, "escaped\xc3\xa9"));
+    E(libj_get_string_ex(libj, escaped, &value, &value_size));
+    assert(value_size == 8 && !memcmp("a\"b\n\xf0\x9f\x98\x80", value, value_size));
+    assert(buffer <= value && value < buffer + sizeof(buffer));
+    E(libj_object_get_real(libj, json, &real, "number"));
+    assert(12.5 == real);
+
+    E(libj_copy(libj, json, &copy));
+    E(libj_free_json(libj, &json));
+    memset(buffer, 'x', sizeof(buffer) - 1);
+    E(libj_object_get_string(libj, copy, &value, "name"));
+    assert(!strcmp("plain", value));
+    E(libj_free_json(libj, &copy));
+
+    char bad[] = "[\"a\\x\"]";
+    CHECK(LIBJ_ERROR_SYNTAX == libj_from_buffer_insitu(libj, &json, bad, sizeof(bad) - 1, &error_string));
+    assert(!strcmp("unknown escape sequence", error_string));
+}
+
+static void view_check(void) {
+    static const char text[] = "{\"plain\": \"abc\", \"escaped\": \"a\\tb\", \"list\": [1, -2.5e1, 3]}";
+    /* No null-terminator after the input so that reading past a view would be caught by sanitizers. */
+    char *buffer = malloc(sizeof(text) - 1);
+    assert(buffer);
+    memcpy(buffer, text, sizeof(text) - 1);
+    LibjJson *json = NULL;
+    const char *error_string = NULL;
+    const char *name = NULL;
+    size_t name_size = 0;
+    LibjJson *member = NULL;
+    char *value = NULL;
+    char *output = NULL;
+    int64_t integer;
+    double real;
+    E(libj_from_buffer_view(libj, &json, buffer, sizeof(text) - 1, &error_string));
+    E(libj_to_string(libj, json, &output, &libj_to_string_options_compact));
+    assert(!strcmp("{\"plain\":\"abc\",\"escaped\":\"a\\tb\",\"list\":[1,-2.5e1,3]}", output));
+    free(output);
+    E(libj_object_get_member_at_ex(libj, json, 0, &name, &name_size, &member));
+    assert(5 == name_size && !strcmp("plain", name));
+    E(libj_object_get_string(libj, json, &value, "plain"));
+    assert(!strcmp("abc", value));
+    assert(value < buffer || buffer + sizeof(text) <= value);
+    E(libj_object_get_string(libj, json, &value, "escaped"));
+    assert(!strcmp("a\tb", value));
+    LibjJson *list = NULL;
+    LibjJson *element = NULL;
+    E(libj_object_get(libj, json, &list, "list"));
+    E(libj_array_get_element_at(libj, list, 1, &element));
+    E(libj_get_real(libj, element, &real));
+    assert(-25.0 == real);
+    E(libj_array_get_element_at(libj, list, 2, &element));
+    E(libj_get_integer(libj, element, &integer));
+    assert(3 == integer);
+    E(libj_free_json(libj, &json));
+
+    memcpy(buffer, "12345", 5);
+    E(libj_from_buffer_view(libj, &json, buffer, 5, &error_string));
+    E(libj_get_integer(libj, json, &integer));
+    assert(12345 == integer);
+    E(libj_free_json(libj, &json));
+    free(buffer);
+}
+
+static void expect_integer(const char *input, LibjError expected_error, int64_t expected) {
+    LibjJson *json = NULL;
+    const char *error_string = NULL;
+    int64_t value = 0;
+    E(libj_from_string(libj, &json, input, &error_string));
+    /* Values are converted once when the number is created and both calls only read them. */
+    for (int i = 0; i < 2; ++i) {
+        CHECK(expected_error == libj_get_integer(libj, json, &value));
+        assert(expected == value);
+    }
+    E(libj_free_json(libj, &json));
+}
+
+static void expect_real(const char *input, LibjError expected_error, double expected) {
+    LibjJson *json = NULL;
+    const char *error_string = NULL;
+    double value = 0;
+    E(libj_from_string(libj, &json, input, &error_string));
+    for (int i = 0; i < 2; ++i) {
+        CHECK(expected_error == libj_get_real(libj, json, &value));
+        assert(expected == value && !signbit(expected) == !signbit(value));
+    }
+    E(libj_free_json(libj, &json));
+}
+
+static void number_check(void) {
+    expect_integer("0", LIBJ_ERROR_OK, 0);
+    expect_integer("-0", LIBJ_ERROR_OK, 0);
+    expect_integer("42", LIBJ_ERROR_OK, 42);
+    expect_integer("9223372036854775807", LIBJ_ERROR_OK, INT64_MAX);
+    expect_integer("-9223372036854775808", LIBJ_ERROR_OK, INT64_MIN);
+    expect_integer("9223372036854775808", LIBJ_ERROR_PRECISION, INT64_MAX);
+    expect_integer("-9223372036854775809", LIBJ_ERROR_PRECISION, INT64_MIN);
+    expect_integer("100000000000000000000000", LIBJ_ERROR_PRECISION, INT64_MAX);
+    expect_integer("1.0", LIBJ_ERROR_OK, 1);
+    expect_integer("1200.00e-2", LIBJ_ERROR_OK, 12);
+    expect_integer("0.05e2", LIBJ_ERROR_OK, 5);
+    expect_integer("1e18", LIBJ_ERROR_OK, 1000000000000000000);
+    expect_integer("0e999999999999", LIBJ_ERROR_OK, 0);
+    expect_integer("1.5", LIBJ_ERROR_PRECISION, 1);
+    expect_integer("-2.75", LIBJ_ERROR_PRECISION, -2);
+    expect_integer("1.0000000000000000001", LIBJ_ERROR_PRECISION, 1);
+    expect_integer("1e-999999999999", LIBJ_ERROR_PRECISION, 0);
+    expect_integer("-1e999", LIBJ_ERROR_PRECISION, INT64_MIN);
+    expect_real("0.5", LIBJ_ERROR_OK, 0.5);
+    expect_real("-0", LIBJ_ERROR_OK, -0.0);
+    expect_real("-12e-1", LIBJ_ERROR_OK, -1.2);
+    expect_real("0.0e-999", LIBJ_ERROR_OK, 0);
+    /* Halfway cases, subnormals and inputs with more digits than fit into 64 bits. */
+    expect_real("9007199254740993", LIBJ_ERROR_OK, 0x1.0000000000000p+53);
+    expect_real("9007199254740995", LIBJ_ERROR_OK, 0x1.0000000000002p+53);
+    expect_real("1.00000000000000011102230246251565404236316680908203125", LIBJ_ERROR_OK, 1);
+    expect_real("123456789012345678901234567890", LIBJ_ERROR_OK, 0x1.8ee90ff6c373ep+96);
+    expect_real("2.2250738585072011e-308", LIBJ_ERROR_OK, 0x0.fffffffffffffp-1022);
+    expect_real("4.9e-324", LIBJ_ERROR_OK, 0x0.0000000000001p-1022);
+    expect_real("0.1e-5", LIBJ_ERROR_OK, 0x1.0c6f7a0b5ed8dp-20);
+    expect_real("1.7976931348623157e308", LIBJ_ERROR_OK, DBL_MAX);
+    expect_real("1e999", LIBJ_ERROR_PRECISION, HUGE_VAL);
+    expect_real("-1e-999", LIBJ_ERROR_PRECISION, -0.0);
+
+    /* Created integers keep their value. */
+    LibjJson *json = NULL;
+    int64_t integer = 0;
+    double real = 0;
+    char *text = NULL;
+    E(libj_integer_create(libj, &json, INT64_MIN));
+    E(libj_get_integer(libj, json, &integer));
+    assert(INT64_MIN == integer);
+    E(libj_get_number(libj, json, &text));
+    assert(!strcmp("-9223372036854775808", text));
+    E(libj_get_real(libj, json, &real));
+    assert(-9223372036854775808.0 == real);
+    E(libj_free_json(libj, &json));
+
+    /* Every number of digits with both signs formats like printf and parses back. */
+    for (uint64_t magnitude = 1; magnitude; magnitude = magnitude <= INT64_MAX / 10 ? magnitude * 10 : 0) {
+        int64_t values[] = { (int64_t) (magnitude - 1), (int64_t) magnitude, -(int64_t) magnitude };
+        for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); ++i) {
+            char expected[32];
+            snprintf(expected, sizeof(expected), "%" PRId64, values[i]);
+            E(libj_integer_create(libj, &json, values[i]));
+            E(libj_get_number(libj, json, &text));
+            assert(!strcmp(expected, text));
+            E(libj_free_json(libj, &json));
+            expect_integer(expected, LIBJ_ERROR_OK, values[i]);
+        }
+    }
+    static const struct {
+        double value;
+        const char *text;
+    } reals[] = {
+        { 0.1, "0.1" }, { -0.0, "-0" }, { 1.5, "1.5" }, { 100, "100" }, { 123456.789, "123456.789" },
+        { 1e21, "1e+21" }, { 1e20, "100000000000000000000" }, { 1e-7, "1e-7" }, { 1e-6, "0.000001" },
+        { 0.3, "0.3" }, { 0.1 + 0.2, "0.30000000000000004" }, { DBL_MAX, "1.7976931348623157e+308" },
+        { DBL_MIN, "2.2250738585072014e-308" }, { 5e-324, "5e-324" }, { 9007199254740993.0, "9007199254740992" },
+    };
+    for (size_t i = 0; i < sizeof(reals) / sizeof(reals[0]); ++i) {
+        E(libj_real_create(libj, &json, reals[i].value));
+        E(libj_get_number(libj, json, &text));
+        assert(!strcmp(reals[i].text, text));
+        E(libj_free_json(libj, &json));
+        expect_real(reals[i].text, LIBJ_ERROR_OK, reals[i].value);
+    }
+    CHECK(LIBJ_ERROR_BAD_ARGUMENT == libj_real_create(libj, &json, NAN));
+    CHECK(LIBJ_ERROR_BAD_ARGUMENT == libj_real_create(libj, &json, INFINITY));
+    /* Wrappers pass the error on instead of aborting. */
+    E(libj_object_create(libj, &json));
+    CHECK(LIBJ_ERROR_BAD_ARGUMENT == libj_object_add_real(libj, json, "a", NAN));
+    CHECK(LIBJ_ERROR_BAD_ARGUMENT == libj_object_set_real(libj, json, "a", -INFINITY));
+    E(libj_free_json(libj, &json));
+    E(libj_array_create(libj, &json));
+    CHECK(LIBJ_ERROR_BAD_ARGUMENT == libj_array_add_real(libj, json, INFINITY));
+    E(libj_free_json(libj, &json));
+
+    E(libj_integer_create(libj, &json, INT64_MAX));
+    E(libj_get_number(libj, json, &text));
+    assert(!strcmp("9223372036854775807", text));
+    E(libj_free_json(libj, &json));
+}
+
+static void typed_number_check(void) {
+    static const char text[] =
+            "[0, -12, 1.50, 1e2, 9223372036854775808, 0.1e-5, 123456789012345678901, 4.9e-324, -0.0]";
+    LibjJson *json = NULL;
+    LibjJson *copy = NULL;
+    LibjJson *element = NULL;
+    const char *error_string = NULL;
+    char *output = NULL;
+    char *number = NULL;
+    int64_t integer = 0;
+    double real = 0;
+    E(libj_use_typed_numbers(libj, true));
+    E(libj_from_string(libj, &json, text, &error_string));
+    E(libj_use_typed_numbers(libj, false));
+    /* Numbers that don't fit keep their text and the rest are formatted from their values. */
+    static const char expected[] = "[0,-12,1.5,100,9223372036854775808,0.000001,123456789012345678901,4.9e-324,-0]";
+    E(libj_to_string(libj, json, &output, &libj_to_string_options_compact));
+    assert(!strcmp(expected, output));
+    free(output);
+    E(libj_copy(libj, json, &copy));
+    E(libj_to_string(libj, copy, &output, &libj_to_string_options_compact));
+    assert(!strcmp(expected, output));
+    free(output);
+    E(libj_free_json(libj, &copy));
+
+    E(libj_array_get_element_at(libj, json, 1, &element));
+    E(libj_get_integer(libj, element, &integer));
+    assert(-12 == integer);
+    E(libj_get_real(libj, element, &real));
+    assert(-12.0 == real);
+    E(libj_array_get_element_at(libj, json, 2, &element));
+    CHECK(LIBJ_ERROR_PRECISION == libj_get_integer(libj, element, &integer));
+    assert(1 == integer);
+    E(libj_get_real(libj, element, &real));
+    assert(1.5 == real);
+    E(libj_get_number(libj, element, &number));
+    assert(!strcmp("1.5", number));
+    E(libj_array_get_element_at(libj, json, 3, &element));
+    E(libj_get_integer(libj, element, &integer));
+    assert(100 == integer);
+    /* Asking for the integer value doesn't change how a real is formatted. */
+    E(libj_get_number(libj, element, &number));
+    assert(!strcmp("100", number));
+    E(libj_array_get_element_at(libj, json, 4, &element));
+    CHECK(LIBJ_ERROR_PRECISION == libj_get_integer(libj, element, &integer));
+    assert(INT64_MAX == integer);
+    /* Text made for a number without text is reused by the next one. */
+    E(libj_array_get_element_at(libj, json, 8, &element));
+    E(libj_get_number(libj, element, &number));
+    assert(!strcmp("-0", number));
+    E(libj_free_json(libj, &json));
+
+    static const char big[] = "4611686018427387904e0";
+    E(libj_use_typed_numbers(libj, true));
+    E(libj_from_buffer_view(libj, &json, big, sizeof(big) - 1, &error_string));
+    E(libj_use_typed_numbers(libj, false));
+    E(libj_get_integer(libj, json, &integer));
+    assert(INT64_C(4611686018427387904) == integer);
+    E(libj_get_number(libj, json, &number));
+    assert(!strcmp("4611686018427388000", number));
+    E(libj_free_json(libj, &json));
+}
+
+/* Events written down one after another. */
+typedef struct {
+    char text[256];
+    size_t size;
+    size_t limit; /* number of events after which parsing is stopped */
+} Trace;
+
+static bool trace(Trace *t, const char *event, const char *bytes, size_t size) {
+    int written = snprintf(t->text + t->size, sizeof(t->text) - t->size, "%s%.*s ", event, (int) size, bytes);
+    assert(0 < written && (size_t) written < sizeof(t->text) - t->size);
+    t->size += written;
+    return --t->limit;
+}
+
+static bool trace_null(void *user) {
+    return trace(user, "null", "", 0);
+}
+
+static bool trace_bool(void *user, bool value) {
+    return trace(user, value ? "true" : "false", "", 0);
+}
+
+static bool trace_number(void *user, const char *text, size_t size) {
+    return trace(user, "#", text, size);
+}
+
+static bool trace_string(void *user, const char *value, size_t size) {
+    return trace(user, "s:", value, size);
+}
+
+static bool trace_object_start(void *user) {
+    return trace(user, "{", "", 0);
+}
+
+static bool trace_key(void *user, const char *name, size_t size) {
+    return trace(user, "k:", name, size);
+}
+
+static bool trace_object_end(void *user) {
+    return trace(user, "}", "", 0);
+}
+
+static bool trace_array_start(void *user) {
+    return trace(user, "[", "", 0);
+}
+
+static bool trace_array_end(void *user) {
+    return trace(user, "]", "", 0);
+}
+
+static const LibjHandler trace_handler = {
+    trace_null, trace_bool, trace_number, trace_string, trace_object_start, trace_key, trace_object_end,
+    trace_array_start, trace_array_end,
+};
+
+static void events_check(void) {
+    static const char text[] = "{\"a\": [1, -2.5e1, \"x\\ty\", true, false, null], \"b\": {}, \"c\\u0041\": []}";
+    static const char expected[] = "{ k:a [ #1 #-2.5e1 s:x\ty true false null ] k:b { } k:cA [ ] } ";
+    const char *error_string = NULL;
+    Trace t = { .limit = SIZE_MAX };
+    E(libj_parse_events(libj, text, sizeof(text) - 1, &trace_handler, &t, &error_string));
+    assert(!strcmp(expected, t.text));
+
+    /* Callbacks that are missing skip their events. */
+    LibjHandler keys = { .on_key = trace_key };
+    Trace only_keys = { .limit = SIZE_MAX };
+    E(libj_parse_events(libj, text, sizeof(text) - 1, &keys, &only_keys, &error_string));
+    assert(!strcmp("k:a k:b k:cA ", only_keys.text));
+
+    Trace stopped = { .limit = 3 };
+    CHECK(LIBJ_ERROR_STOPPED == libj_parse_events(libj, text, sizeof(text) - 1, &trace_handler, &stopped,
+                                                  &error_string));
+    assert(!strcmp("{ k:a [ ", stopped.text));
+    assert(!strcmp(libj_error_to_human_readable_string(LIBJ_ERROR_STOPPED), error_string));
+
+    Trace bad = { .limit = SIZE_MAX };
+    CHECK(LIBJ_ERROR_SYNTAX == libj_parse_events(libj, "[1, }", 5, &trace_handler, &bad, &error_string));
+    assert(!strcmp("[ #1 ", bad.text));
+}
+
+/* Write tokens of reader down the same way trace() does until the value is over. */
+static void read_all(LibjReader *reader, Trace *t) {
+    static const char *names[] = { "", "null", "true", "false", "#", "s:", "k:", "{", "}", "[", "]" };
+    const char *error_string = NULL;
+    LibjToken token;
+    for (;;) {
+        E(libj_reader_next(libj, reader, &token, &error_string));
+        if (LIBJ_TOKEN_END == token.type) {
+            break;
+        }
+        trace(t, names[token.type], token.value ? token.value : "", token.value_size);
+    }
+}
+
+static void reader_check(void) {
+    static const char text[] = "{\"a\": [1, -2.5e1, \"x\\ty\", true, false, null], \"b\": {}, \"c\\u0041\": []}";
+    static const char expected[] = "{ k:a [ #1 #-2.5e1 s:x\ty true false null ] k:b { } k:cA [ ] } ";
+    LibjReader *reader = NULL;
+    const char *error_string = NULL;
+    LibjToken token;
+    Trace t = { .limit = SIZE_MAX };
+    E(libj_reader_create_from_buffer(libj, text, sizeof(text) - 1, &reader));
+    read_all(reader, &t);
+    assert(!strcmp(expected, t.text));
+    E(libj_reader_next(libj, reader, &token, &error_string));
+    assert(LIBJ_TOKEN_END == token.type);
+    E(libj_reader_free(libj, &reader));
+
+    /* Streams give the same tokens. */
+    Libis *libis = NULL;
+    LibisSource *source = NULL;
+    LibisInputStream *input = NULL;
+    CHECK(LIBIS_ERROR_OK == libis_start(&libis));
+    CHECK(LIBIS_ERROR_OK == libis_source_create_from_buffer(libis, &source, text, sizeof(text) - 1, false));
+    CHECK(LIBIS_ERROR_OK == libis_create(libis, &input, &source, 1));
+    E(libj_reader_create(libj, input, &reader));
+    Trace from_stream = { .limit = SIZE_MAX };
+    read_all(reader, &from_stream);
+    assert(!strcmp(expected, from_stream.text));
+    E(libj_reader_free(libj, &reader));
+    libis_source_destroy(libis, &source);
+    libis_destroy(libis, &input);
+    libis_finish(&libis);
+
+    /* Member names are skipped with their values, strings in skipped values may hold brackets. */
+    static const char skipped[] = "[{\"a\": {\"x\": [\"]}\\\"\", {}]}, \"b\": 2}, [[3]], \"s\", 4]";
+    E(libj_reader_create_from_buffer(libj, skipped, sizeof(skipped) - 1, &reader));
+    E(libj_reader_next(libj, reader, &token, &error_string));
+    assert(LIBJ_TOKEN_ARRAY_START == token.type);
+    E(libj_reader_next(libj, reader, &token, &error_string));
+    assert(LIBJ_TOKEN_OBJECT_START == token.type);
+    E(libj_reader_skip_value(libj, reader, &error_string));
+    E(libj_reader_next(libj, reader, &token, &error_string));
+    assert(LIBJ_TOKEN_KEY == token.type && 1 == token.value_size && 'b' == *token.value);
+    E(libj_reader_skip_value(libj, reader, &error_string));
+    /* There's nothing to skip at the end of an object. */
+    E(libj_reader_skip_value(libj, reader, &error_string));
+    E(libj_reader_next(libj, reader, &token, &error_string));
+    assert(LIBJ_TOKEN_OBJECT_END == token.type);
+    E(libj_reader_skip_value(libj, reader, &error_string));
+    E(libj_reader_skip_value(libj, reader, &error_string));
+    Trace rest = { .limit = SIZE_MAX };
+    read_all(reader, &rest);
+    assert(!strcmp("#4 ] ", rest.text));
+    E(libj_reader_free(libj, &reader));
+
+    E(libj_reader_create_from_buffer(libj, "[[1}]", 5, &reader));
+    E(libj_reader_next(libj, reader, &token, &error_string));
+    CHECK(LIBJ_ERROR_SYNTAX == libj_reader_skip_value(libj, reader, &error_string));
+    CHECK(LIBJ_ERROR_SYNTAX == libj_reader_next(libj, reader, &token, &error_string));
+    E(libj_reader_free(libj, &reader));
+    E(libj_reader_create_from_buffer(libj, "[1 2]", 5, &reader));
+    E(libj_reader_next(libj, reader, &token, &error_string));
+    E(libj_reader_next(libj, reader, &token, &error_string));
+    CHECK(LIBJ_ERROR_SYNTAX == libj_reader_next(libj, reader, &token, &error_string));
+    assert(!strcmp("] or , was expected", error_string));
+    /* The message outlives other calls with libj. */
+    LibjJson *json = NULL;
+    CHECK(LIBJ_ERROR_SYNTAX == libj_from_string(libj, &json, "[", &error_string));
+    CHECK(LIBJ_ERROR_SYNTAX == libj_reader_next(libj, reader, &token, &error_string));
+    assert(!strcmp("] or , was expected", error_string));
+    E(libj_reader_free(libj, &reader));
+}
+
+/* Feed input to a new push parser in chunks of chunk_size bytes and then end it. The message goes away with the
+ * parser, so a copy of it is returned. */
+static LibjError feed_all(const char *input, size_t input_size, size_t chunk_size, LibjJson **json,
+                          const char **error_string) {
+    LibjPushParser *parser = NULL;
+    LibjFeedStatus status = LIBJ_FEED_NEED_MORE;
+    LibjError err = LIBJ_ERROR_OK;
+    E(libj_push_parser_create(libj, &parser));
+    for (size_t i = 0; !err && i < input_size; i += chunk_size) {
+        size_t size = input_size - i < chunk_size ? input_size - i : chunk_size;
+        err = libj_feed(libj, parser, input + i, size, &status, json, error_string);
+        if (LIBJ_FEED_DONE == status) {
+            break;
+        }
+    }
+    if (!err && LIBJ_FEED_DONE != status) {
+        err = libj_feed(libj, parser, NULL, 0, &status, json, error_string);
+        assert(err || LIBJ_FEED_DONE == status);
+    }
+    static char message[256];
+    snprintf(message, sizeof(message), "%s", *error_string);
+    *error_string = message;
+    E(libj_push_parser_free(libj, &parser));
+    return err;
+}
+
+/* Values split at every byte give the same json as when they are parsed at once. */
+static void feed_check(void) {
+    static const char *inputs[] = {
+            "{\"a\": [1, -2.5e1, \"x\\ty\\\"\", true, false, null], \"b\": {}, \"c\\u0041\": [[]]}",
+            " \"\xe2\x82\xac\\u00e9\" ",
+            "-12.5e-3",
+            "[\"\\\\\", \"\\\\\\\"]\"]",
+    };
+    for (size_t i = 0; i < sizeof(inputs) / sizeof(*inputs); ++i) {
+        size_t input_size = strlen(inputs[i]);
+        LibjJson *json = NULL;
+        const char *error_string = NULL;
+        char *expected = NULL;
+        E(libj_from_string(libj, &json, inputs[i], &error_string));
+        E(libj_to_string(libj, json, &expected, &libj_to_string_options_compact));
+        E(libj_free_json(libj, &json));
+        for (size_t chunk_size = 1; chunk_size <= input_size; ++chunk_size) {
+            char *output = NULL;
+            E(feed_all(inputs[i], input_size, chunk_size, &json, &error_string));
+            E(libj_to_string(libj, json, &output, &libj_to_string_options_compact));
+            assert(!strcmp(expected, output));
+            free(output);
+            E(libj_free_json(libj, &json));
+        }
+        free(expected);
+    }
+
+    /* Byte order mark may be split too. */
+    LibjPushParser *parser = NULL;
+    LibjFeedStatus status;
+    LibjJson *json = NULL;
+    const char *error_string = NULL;
+    LibjJson *element = NULL;
+    int64_t value;
+    E(feed_all("\xEF\xBB\xBF[7]", 6, 1, &json, &error_string));
+    E(libj_array_get_element_at(libj, json, 0, &element));
+    E(libj_get_integer(libj, element, &value));
+    assert(7 == value);
+    E(libj_free_json(libj, &json));
+
+    /* Containers are done as soon as they are closed, whatever follows. */
+    E(libj_push_parser_create(libj, &parser));
+    E(libj_feed(libj, parser, "[1, [", 5, &status, &json, &error_string));
+    assert(LIBJ_FEED_NEED_MORE == status && !json);
+    E(libj_feed(libj, parser, "]] x", 4, &status, &json, &error_string));
+    assert(LIBJ_FEED_DONE == status && json);
+    E(libj_free_json(libj, &json));
+    E(libj_feed(libj, parser, "[", 1, &status, &json, &error_string));
+    assert(LIBJ_FEED_DONE == status && !json);
+    E(libj_push_parser_free(libj, &parser));
+
+    CHECK(LIBJ_ERROR_SYNTAX == feed_all("[1 2]", 5, 2, &json, &error_string));
+    assert(!strcmp("] or , was expected", error_string));
+    CHECK(LIBJ_ERROR_SYNTAX == feed_all("{\"a\":1true}", 11, 3, &json, &error_string));
+    assert(!strcmp("} or , was expected", error_string));
+    CHECK(LIBJ_ERROR_SYNTAX == feed_all("{\"a\" 1}", 7, 1, &json, &error_string));
+    assert(!strcmp("':' was expected", error_string));
+    CHECK(LIBJ_ERROR_SYNTAX == feed_all("[\"a", 3, 1, &json, &error_string));
+    assert(!strcmp("unexpected end of file", error_string));
+    CHECK(LIBJ_ERROR_SYNTAX == feed_all("[\"\\x\"]", 6, 1, &json, &error_string));
+    assert(!json);
+
+    /* A parser that failed keeps failing. */
+    E(libj_push_parser_create(libj, &parser));
+    CHECK(LIBJ_ERROR_SYNTAX == libj_feed(libj, parser, "[,", 2, &status, &json, &error_string));
+    assert(!strcmp("json value was expected", error_string));
+    CHECK(LIBJ_ERROR_SYNTAX == libj_from_string(libj, &json, "[1 2]", &error_string));
+    CHECK(LIBJ_ERROR_SYNTAX == libj_feed(libj, parser, "1]", 2, &status, &json, &error_string));
+    assert(!strcmp("json value was expected", error_string));
+    E(libj_push_parser_free(libj, &parser));
+}
+
+void parser_check(void) {
+    whitespace_check();
+    string_check();
+    bad_string_check();
+    insitu_check();
+    view_check();
+    number_check();
+    typed_number_check();
+    events_check();
+    reader_check();
+    feed_check();
+}
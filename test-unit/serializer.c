@@ -0,0 +1,320 @@
+#include "test.h"
+
+#include <unistd.h>
+
+static void check_output(const char *input, LibjToStringOptions *options, const char *expected) {
+    LibjJson *json = NULL;
+    const char *error_string = NULL;
+    char *output = NULL;
+    size_t output_size = 0;
+    E(libj_from_string(libj, &json, input, &error_string));
+    E(libj_to_string_ex(libj, json, &output, &output_size, options));
+    assert(strlen(expected) == output_size);
+    assert(!strcmp(expected, output));
+    free(output);
+    E(libj_free_json(libj, &json));
+}
+
+static void escape_check(void) {
+    check_output("\"\\\"\\\\/\\b\\f\\n\\r\\t\\u0000\\u001f\"", &libj_to_string_options_compact,
+                 "\"\\\"\\\\/\\b\\f\\n\\r\\t\\u0000\\u001f\"");
+    /* Indent placeholder is only special in options, not in values. */
+    check_output("{\"$\": \"a$b\"}", &libj_to_string_options_compact, "{\"$\":\"a$b\"}");
+    check_output("[\"$\"]", &libj_to_string_options_pretty, "[\n    \"$\"\n]");
+}
+
+static void ascii_only_check(void) {
+    LibjToStringOptions options = libj_to_string_options_compact;
+    options.ascii_only = true;
+    check_output("\"a\xc3\xa9\xe2\x82\xac\xf0\x9f\x98\x80z\"", &options, "\"a\\u00e9\\u20ac\\ud83d\\ude00z\"");
+}
+
+static void options_check(void) {
+    LibjToStringOptions options = libj_to_string_options_pretty;
+    options.indent_string = "..";
+    options.colon_prefix = "$";
+    check_output("{\"a\": [1, {\"b\": null}]}", &options,
+                 "{\n..\"a\"..: [\n....1,\n....{\n......\"b\"......: null\n....}\n..]\n}");
+}
+
+typedef struct {
+    char *data;
+    size_t size;
+    size_t calls;
+    size_t fail_after;
+} Collected;
+
+static bool collect(void *user, const char *bytes, size_t size) {
+    Collected *collected = user;
+    if (collected->fail_after && collected->fail_after == collected->calls) {
+        return false;
+    }
+    ++collected->calls;
+    collected->data = realloc(collected->data, collected->size + size);
+    assert(collected->data);
+    memcpy(collected->data + collected->size, bytes, size);
+    collected->size += size;
+    return true;
+}
+
+/* Output goes through several chunks and has a string longer than a chunk. */
+static void writer_check(void) {
+    LibjJson *json = NULL;
+    char *expected = NULL;
+    size_t expected_size = 0;
+    E(libj_array_create(libj, &json));
+    for (int i = 0; i < 20000; ++i) {
+        E(libj_array_add_integer(libj, json, i));
+    }
+    char *big = malloc(200000);
+    assert(big);
+    memset(big, 'x', 199999);
+    big[199999] = '\0';
+    E(libj_array_add_string(libj, json, big));
+    free(big);
+    E(libj_to_string_ex(libj, json, &expected, &expected_size, &libj_to_string_options_pretty));
+
+    Collected collected = { 0 };
+    E(libj_to_writer(libj, json, collect, &collected, &libj_to_string_options_pretty));
+    assert(2 < collected.calls);
+    assert(expected_size == collected.size);
+    assert(!memcmp(expected, collected.data, expected_size));
+    free(collected.data);
+
+    Collected failing = { .fail_after = 1 };
+    CHECK(LIBJ_ERROR_IO == libj_to_writer(libj, json, collect, &failing, &libj_to_string_options_pretty));
+    assert(1 == failing.calls);
+    free(failing.data);
+
+    FILE *file = tmpfile();
+    assert(file);
+    E(libj_to_fd(libj, json, fileno(file), &libj_to_string_options_pretty));
+    CHECK(0 == fseek(file, 0, SEEK_END));
+    CHECK((long) expected_size == ftell(file));
+    rewind(file);
+    char *written = malloc(expected_size);
+    assert(written);
+    CHECK(expected_size == fread(written, 1, expected_size, file));
+    assert(!memcmp(expected, written, expected_size));
+    free(written);
+    fclose(file);
+
+    free(expected);
+    E(libj_free_json(libj, &json));
+}
+
+/* Read every record of text and write them down compact separated with spaces. */
+static char *read_records(const char *text, size_t text_size, LibjError *err, const char **error_string) {
+    Libis *libis = NULL;
+    LibisSource *source = NULL;
+    LibisInputStream *input = NULL;
+    Collected records = { 0 };
+    size_t offset = 0;
+    CHECK(LIBIS_ERROR_OK == libis_start(&libis));
+    CHECK(LIBIS_ERROR_OK == libis_source_create_from_buffer(libis, &source, text, text_size, false));
+    CHECK(LIBIS_ERROR_OK == libis_create(libis, &input, &source, 1));
+    for (;;) {
+        LibjJson *json = NULL;
+        char *record = NULL;
+        size_t record_size;
+        *err = libj_ndjson_next(libj, input, &offset, &json, error_string);
+        if (*err || !json) {
+            break;
+        }
+        E(libj_to_string_ex(libj, json, &record, &record_size, &libj_to_string_options_compact));
+        collect(&records, record, record_size);
+        collect(&records, " ", 1);
+        free(record);
+        E(libj_free_json(libj, &json));
+    }
+    collect(&records, "", 1);
+    libis_source_destroy(libis, &source);
+    libis_destroy(libis, &input);
+    libis_finish(&libis);
+    return records.data;
+}
+
+/* Records written by the writer are read back one by one. */
+static void ndjson_check(void) {
+    static const char *values[] = { "{\"a\": \"x\\ny\"}", "[1, 2]", "3", "\"s\"", "null" };
+    LibjNdjsonWriter *writer = NULL;
+    Collected collected = { 0 };
+    LibjError err;
+    const char *error_string = NULL;
+    E(libj_ndjson_writer_create(libj, collect, &collected, &writer));
+    for (size_t i = 0; i < sizeof(values) / sizeof(*values); ++i) {
+        LibjJson *json = NULL;
+        E(libj_from_string(libj, &json, values[i], &error_string));
+        E(libj_ndjson_write(libj, writer, json));
+        E(libj_free_json(libj, &json));
+    }
+    /* Nothing is written until the chunk is full or flushed. */
+    assert(!collected.calls);
+    E(libj_ndjson_writer_flush(libj, writer));
+    assert(1 == collected.calls);
+    E(libj_ndjson_writer_free(libj, &writer));
+    static const char expected[] = "{\"a\":\"x\\ny\"}\n[1,2]\n3\n\"s\"\nnull\n";
+    assert(sizeof(expected) - 1 == collected.size && !memcmp(expected, collected.data, collected.size));
+
+    char *records = read_records(collected.data, collected.size, &err, &error_string);
+    assert(LIBJ_ERROR_OK == err);
+    assert(!strcmp("{\"a\":\"x\\ny\"} [1,2] 3 \"s\" null ", records));
+    free(records);
+    free(collected.data);
+
+    static const char blank_lines[] = "\n  {}\r\n\n\t[]  \n4";
+    records = read_records(blank_lines, sizeof(blank_lines) - 1, &err, &error_string);
+    assert(LIBJ_ERROR_OK == err);
+    assert(!strcmp("{} [] 4 ", records));
+    free(records);
+    static const char two_values[] = "1\n2 3\n";
+    records = read_records(two_values, sizeof(two_values) - 1, &err, &error_string);
+    assert(LIBJ_ERROR_SYNTAX == err);
+    assert(!strcmp("1 ", records));
+    assert(!strcmp("record at byte 2: newline was expected", error_string));
+    free(records);
+    /* A record ends with its line even if the value goes on. */
+    static const char split_value[] = "1\n\n[1,\n2]\n";
+    records = read_records(split_value, sizeof(split_value) - 1, &err, &error_string);
+    assert(LIBJ_ERROR_SYNTAX == err);
+    assert(!strcmp("1 ", records));
+    assert(!strcmp("record at byte 3: json value was expected", error_string));
+    free(records);
+}
+
+typedef struct {
+    size_t count;
+    size_t next; /* value of "i" that the next record has when records come in order */
+    bool in_order;
+    size_t offset_sum;
+    size_t stop_after;
+} Records;
+
+static bool count_record(void *user, LibjJson *json, size_t offset) {
+    Records *records = user;
+    int64_t value;
+    E(libj_object_get_integer(libj, json, &value, "i"));
+    records->in_order = records->in_order && (size_t) value == records->next;
+    ++records->next;
+    ++records->count;
+    records->offset_sum += offset;
+    E(libj_free_json(libj, &json));
+    return records->count != records->stop_after;
+}
+
+/* Records of input that spans many pieces come either in order or all of them at least. */
+static void parallel_check(void) {
+    const size_t count = 100000;
+    char *text = malloc(count * 64);
+    assert(text);
+    size_t size = 0;
+    size_t offset_sum = 0;
+    for (size_t i = 0; i < count; ++i) {
+        offset_sum += size;
+        size += sprintf(text + size, "{\"i\": %zu, \"s\": \"line\\nbreak %zu\"}\n", i, i);
+    }
+    const char *error_string = NULL;
+    Records ordered = { .in_order = true };
+    E(libj_ndjson_parse_parallel(libj, text, size, 4, true, count_record, &ordered, &error_string));
+    assert(count == ordered.count && ordered.in_order && offset_sum == ordered.offset_sum);
+    Records unordered = { .in_order = true };
+    E(libj_ndjson_parse_parallel(libj, text, size, 4, false, count_record, &unordered, &error_string));
+    assert(count == unordered.count && offset_sum == unordered.offset_sum);
+
+    /* Records before a bad one all come in order. */
+    char *bad = strstr(text + size / 2, "\n{") + 1;
+    *bad = '[';
+    size_t bad_offset = bad - text;
+    Records before_error = { .in_order = true };
+    CHECK(LIBJ_ERROR_SYNTAX == libj_ndjson_parse_parallel(libj, text, size, 3, true, count_record, &before_error,
+                                                         &error_string));
+    assert(before_error.in_order);
+    char expected[64];
+    sprintf(expected, "record at byte %zu: ", bad_offset);
+    assert(!strncmp(expected, error_string, strlen(expected)));
+    *bad = '{';
+
+    Records stopped = { .in_order = true, .stop_after = 10 };
+    CHECK(LIBJ_ERROR_STOPPED == libj_ndjson_parse_parallel(libj, text, size, 2, false, count_record, &stopped,
+                                                          &error_string));
+    assert(10 == stopped.count);
+    assert(!strcmp(libj_error_to_human_readable_string(LIBJ_ERROR_STOPPED), error_string));
+
+    char path[] = "/tmp/libj_ndjson_XXXXXX";
+    int fd = mkstemp(path);
+    assert(0 <= fd);
+    FILE *file = fdopen(fd, "wb");
+    CHECK(file && size == fwrite(text, 1, size, file));
+    fclose(file);
+    Records from_file = { .in_order = true };
+    E(libj_ndjson_parse_file(libj, path, 0, true, count_record, &from_file, &error_string));
+    assert(count == from_file.count && from_file.in_order);
+    unlink(path);
+    CHECK(LIBJ_ERROR_IO == libj_ndjson_parse_file(libj, path, 0, true, count_record, &from_file, &error_string));
+    free(text);
+}
+
+/* A record that starts in the first piece of input and goes on past its end fails the same way whether records
+ * are read one by one or in parallel. */
+static void piece_end_check(void) {
+    const size_t piece_size = 1 << 16;
+    char *text = malloc(2 * piece_size);
+    assert(text);
+    size_t size = 0;
+    size_t count = 0;
+    while (size + 16 < piece_size) {
+        size += sprintf(text + size, "{\"i\": %zu}\n", count++);
+    }
+    size_t bad_offset = size;
+    size += sprintf(text + size, "[1,");
+    while (size <= piece_size) {
+        text[size++] = ' ';
+    }
+    size += sprintf(text + size, "\n2]\n{\"i\": %zu}\n", count);
+
+    Libis *libis = NULL;
+    LibisSource *source = NULL;
+    LibisInputStream *input = NULL;
+    CHECK(LIBIS_ERROR_OK == libis_start(&libis));
+    CHECK(LIBIS_ERROR_OK == libis_source_create_from_buffer(libis, &source, text, size, false));
+    CHECK(LIBIS_ERROR_OK == libis_create(libis, &input, &source, 1));
+    Records sequential = { .in_order = true };
+    const char *error_string = NULL;
+    size_t offset = 0;
+    LibjError err;
+    for (;;) {
+        LibjJson *json = NULL;
+        err = libj_ndjson_next(libj, input, &offset, &json, &error_string);
+        if (err || !json) {
+            break;
+        }
+        count_record(&sequential, json, 0);
+    }
+    char *sequential_error = strdup(error_string);
+    libis_source_destroy(libis, &source);
+    libis_destroy(libis, &input);
+    libis_finish(&libis);
+    assert(LIBJ_ERROR_SYNTAX == err);
+    assert(count == sequential.count);
+
+    Records parallel = { .in_order = true };
+    CHECK(LIBJ_ERROR_SYNTAX == libj_ndjson_parse_parallel(libj, text, size, 2, true, count_record, &parallel,
+                                                         &error_string));
+    assert(count == parallel.count && parallel.in_order);
+    assert(!strcmp(sequential_error, error_string));
+    char expected[64];
+    sprintf(expected, "record at byte %zu: ", bad_offset);
+    assert(!strncmp(expected, error_string, strlen(expected)));
+    free(sequential_error);
+    free(text);
+}
+
+void serializer_check(void) {
+    escape_check();
+    ascii_only_check();
+    options_check();
+    writer_check();
+    ndjson_check();
+    parallel_check();
+    piece_end_check();
+}
@@ -21,7 +21,23 @@ extern Libj *libj;
         } \
     } while (0);
 
+/* Unlike assert this is never compiled out, so condition may call functions with side effects. */
+#define CHECK(condition) do { \
+        if (!(condition)) { \
+            printf(__FILE__":%d at %s: check '"#condition"' failed\n", __LINE__, __func__); \
+            exit(EXIT_FAILURE); \
+        } \
+    } while (0)
+
 void sanity_check(void);
 
+void containers_check(void);
+
+void document_check(void);
+
+void parser_check(void);
+
+void serializer_check(void);
+
 #endif
 